@@ -37,6 +37,7 @@ struct {
 	{"edit", cmd_edit, "Edit a drive entry"},
 	{"prioritize", cmd_prioritize, "Reorder the priority of all kernel partitions"},
 	{"legacy", cmd_legacy, "Switch between GPT and Legacy GPT"},
+	{"batch", cmd_batch, "Apply several edits with one read and write"},
 };
 
 static void Usage(void)
@@ -14,6 +14,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "cgpt_endian.h"
+#include "cgpt_params.h"
 #include "cgptlib.h"
 #include "gpt.h"
 
@@ -48,6 +49,13 @@ struct drive {
   GptData gpt;
   struct pmbr pmbr;
   int fd;       /* file descriptor */
+  /* For regular files, a private copy-on-write mapping of the whole file
+   * which the GPT buffers may point into, and a read-only shared one that
+   * saves compare against if the file is open for writing.  NULL if not
+   * mapped. */
+  uint8_t *map;
+  uint8_t *shared_map;
+  size_t map_size;
 };
 
 // Opens a block device or file, loads raw GPT data from it.
@@ -160,6 +168,23 @@ int IsBootable(struct drive *drive, int secondary, uint32_t index);
 
 uint64_t DriveLastUsableLBA(const struct drive *drive);
 
+// Apply a command to a drive that's already open and has passed
+// GptValidityCheck() and CheckValid(). The GPT is only updated in memory;
+// the caller writes it out with DriveClose(). CgptBootOnDrive() only updates
+// drive->pmbr, which the caller writes out with WritePMBR().
+//
+// Returns CGPT_OK or CGPT_FAILED. On failure the drive may be partially
+// modified and shouldn't be written out.
+int CgptAddOnDrive(struct drive *drive, CgptAddParams *params);
+int CgptEditOnDrive(struct drive *drive, CgptEditParams *params);
+int CgptPrioritizeOnDrive(struct drive *drive, CgptPrioritizeParams *params);
+int CgptBootOnDrive(struct drive *drive, CgptBootParams *params);
+
+// Set by 'cgpt batch' while it runs a script. When non-NULL, the add, edit,
+// prioritize and boot commands take no DRIVE argument and apply their edits
+// to this drive instead.
+extern struct drive *batch_drive;
+
 // Optional. Applications that need this must provide an implementation.
 //
 // Explanation:
@@ -186,6 +211,7 @@ int cmd_find(int argc, char *argv[]);
 int cmd_edit(int argc, char *argv[]);
 int cmd_prioritize(int argc, char *argv[]);
 int cmd_legacy(int argc, char *argv[]);
+int cmd_batch(int argc, char *argv[]);
 
 #define ARRAY_COUNT(array) (sizeof(array)/sizeof((array)[0]))
 const char *GptError(int errnum);
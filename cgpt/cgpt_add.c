@@ -281,10 +281,22 @@ static int GptAdd(struct drive *drive, CgptAddParams *params, uint32_t index)
 	return 0;
 }
 
+int CgptAddOnDrive(struct drive *drive, CgptAddParams *params)
+{
+	uint32_t index;
+
+	if (CgptGetUnusedPartition(drive, &index, params))
+		return CGPT_FAILED;
+
+	if (GptAdd(drive, params, index))
+		return CGPT_FAILED;
+
+	return CGPT_OK;
+}
+
 int CgptAdd(CgptAddParams *params)
 {
 	struct drive drive;
-	uint32_t index;
 
 	if (params == NULL)
 		return CGPT_FAILED;
@@ -296,11 +308,7 @@ int CgptAdd(CgptAddParams *params)
 		goto bad;
 	}
 
-	if (CgptGetUnusedPartition(&drive, &index, params)) {
-		goto bad;
-	}
-
-	if (GptAdd(&drive, params, index))
+	if (CGPT_OK != CgptAddOnDrive(&drive, params))
 		goto bad;
 
 	// Write it all out.
@@ -61,86 +61,95 @@ done:
 	return retval;
 }
 
-int CgptBoot(CgptBootParams *params)
+int CgptBootOnDrive(struct drive *drive, CgptBootParams *params)
 {
-	struct drive drive;
-	int retval = 1;
-	int gpt_retval = 0;
-	int mode = O_RDONLY;
-
-	if (params == NULL)
-		return CGPT_FAILED;
-
-	if (params->create_pmbr || params->partition || params->bootfile)
-		mode = O_RDWR;
-
-	if (CGPT_OK != DriveOpen(params->drive_name, &drive, mode, params->drive_size)) {
-		return CGPT_FAILED;
-	}
-
-	if (CGPT_OK != ReadPMBR(&drive)) {
-		Error("Unable to read PMBR\n");
-		goto done;
-	}
-
 	if (params->create_pmbr) {
-		drive.pmbr.magic[0] = 0x1d;
-		drive.pmbr.magic[1] = 0x9a;
-		drive.pmbr.sig[0] = 0x55;
-		drive.pmbr.sig[1] = 0xaa;
-		memset(&drive.pmbr.part, 0, sizeof(drive.pmbr.part));
-		drive.pmbr.part[0].f_head = 0x00;
-		drive.pmbr.part[0].f_sect = 0x02;
-		drive.pmbr.part[0].f_cyl = 0x00;
-		drive.pmbr.part[0].type = 0xee;
-		drive.pmbr.part[0].l_head = 0xff;
-		drive.pmbr.part[0].l_sect = 0xff;
-		drive.pmbr.part[0].l_cyl = 0xff;
-		drive.pmbr.part[0].f_lba = htole32(1);
+		drive->pmbr.magic[0] = 0x1d;
+		drive->pmbr.magic[1] = 0x9a;
+		drive->pmbr.sig[0] = 0x55;
+		drive->pmbr.sig[1] = 0xaa;
+		memset(&drive->pmbr.part, 0, sizeof(drive->pmbr.part));
+		drive->pmbr.part[0].f_head = 0x00;
+		drive->pmbr.part[0].f_sect = 0x02;
+		drive->pmbr.part[0].f_cyl = 0x00;
+		drive->pmbr.part[0].type = 0xee;
+		drive->pmbr.part[0].l_head = 0xff;
+		drive->pmbr.part[0].l_sect = 0xff;
+		drive->pmbr.part[0].l_cyl = 0xff;
+		drive->pmbr.part[0].f_lba = htole32(1);
 		uint32_t max = 0xffffffff;
-		if (drive.gpt.streaming_drive_sectors < 0xffffffff)
-			max = drive.gpt.streaming_drive_sectors - 1;
-		drive.pmbr.part[0].num_sect = htole32(max);
+		if (drive->gpt.streaming_drive_sectors < 0xffffffff)
+			max = drive->gpt.streaming_drive_sectors - 1;
+		drive->pmbr.part[0].num_sect = htole32(max);
 	}
 
 	if (params->partition) {
-		if (GPT_SUCCESS != (gpt_retval = GptValidityCheck(&drive.gpt))) {
-			Error("GptValidityCheck() returned %d: %s\n", gpt_retval,
-			      GptError(gpt_retval));
-			goto done;
-		}
-
-		if (params->partition > GetNumberOfEntries(&drive)) {
+		if (params->partition > GetNumberOfEntries(drive)) {
 			Error("invalid partition number: %d\n", params->partition);
-			goto done;
+			return CGPT_FAILED;
 		}
 
 		uint32_t index = params->partition - 1;
-		GptEntry *entry = GetEntry(&drive.gpt, ANY_VALID, index);
-		memcpy(&drive.pmbr.boot_guid, &entry->unique, sizeof(Guid));
+		GptEntry *entry = GetEntry(&drive->gpt, ANY_VALID, index);
+		memcpy(&drive->pmbr.boot_guid, &entry->unique, sizeof(Guid));
 	}
 
 	if (params->bootfile) {
 		int fd = open(params->bootfile, O_RDONLY);
 		if (fd < 0) {
 			Error("Can't read %s: %s\n", params->bootfile, strerror(errno));
-			goto done;
+			return CGPT_FAILED;
 		}
 
-		int n = read(fd, drive.pmbr.bootcode, sizeof(drive.pmbr.bootcode));
+		int n = read(fd, drive->pmbr.bootcode, sizeof(drive->pmbr.bootcode));
 		if (n < 1) {
 			Error("problem reading %s: %s\n", params->bootfile, strerror(errno));
 			close(fd);
-			goto done;
+			return CGPT_FAILED;
 		}
 
 		close(fd);
 	}
 
 	char buf[GUID_STRLEN];
-	GptGuidToStr(&drive.pmbr.boot_guid, buf, sizeof(buf), GPT_GUID_UPPERCASE);
+	GptGuidToStr(&drive->pmbr.boot_guid, buf, sizeof(buf), GPT_GUID_UPPERCASE);
 	printf("%s\n", buf);
 
+	return CGPT_OK;
+}
+
+int CgptBoot(CgptBootParams *params)
+{
+	struct drive drive;
+	int retval = 1;
+	int gpt_retval = 0;
+	int mode = O_RDONLY;
+
+	if (params == NULL)
+		return CGPT_FAILED;
+
+	if (params->create_pmbr || params->partition || params->bootfile)
+		mode = O_RDWR;
+
+	if (CGPT_OK != DriveOpen(params->drive_name, &drive, mode, params->drive_size)) {
+		return CGPT_FAILED;
+	}
+
+	if (CGPT_OK != ReadPMBR(&drive)) {
+		Error("Unable to read PMBR\n");
+		goto done;
+	}
+
+	if (params->partition &&
+	    GPT_SUCCESS != (gpt_retval = GptValidityCheck(&drive.gpt))) {
+		Error("GptValidityCheck() returned %d: %s\n", gpt_retval,
+		      GptError(gpt_retval));
+		goto done;
+	}
+
+	if (CGPT_OK != CgptBootOnDrive(&drive, params))
+		goto done;
+
 	// Write it all out, if needed.
 	if (mode == O_RDONLY || CGPT_OK == WritePMBR(&drive))
 		retval = 0;
@@ -19,6 +19,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
 #include <sys/mount.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -104,12 +105,7 @@ int Load(struct drive *drive, uint8_t *buf, const uint64_t sector, const uint64_
 	}
 	count = sector_bytes * sector_count;
 
-	if (-1 == lseek(drive->fd, sector * sector_bytes, SEEK_SET)) {
-		Error("Can't seek: %s\n", strerror(errno));
-		return CGPT_FAILED;
-	}
-
-	nread = read(drive->fd, buf, count);
+	nread = pread(drive->fd, buf, count, sector * sector_bytes);
 	if (nread < count) {
 		Error("Can't read enough: %d, not %d\n", nread, count);
 		return CGPT_FAILED;
@@ -142,6 +138,67 @@ int WritePMBR(struct drive *drive)
 	return CGPT_OK;
 }
 
+// Returns whether the file has a hole in 'size' bytes at 'offset'. Faulting
+// in a hole through a mapping may need a block, and if the filesystem is full
+// that raises SIGBUS rather than failing a read() or write().
+static int HasHole(const struct drive *drive, uint64_t offset, uint64_t size)
+{
+#ifdef SEEK_HOLE
+	off_t hole = lseek(drive->fd, offset, SEEK_HOLE);
+
+	return hole < 0 || (uint64_t)hole < offset + size;
+#else
+	return 0;
+#endif
+}
+
+// Returns where 'size' bytes starting at 'sector' are in the private mapping
+// of the drive, or NULL if the drive isn't mapped, they're past its end, or
+// they aren't all backed by disk blocks.
+static uint8_t *MappedSectors(const struct drive *drive, uint64_t sector, uint64_t size)
+{
+	uint64_t offset;
+
+	if (!drive->map || sector > drive->map_size / drive->gpt.sector_bytes)
+		return NULL;
+
+	offset = sector * drive->gpt.sector_bytes;
+	if (size > drive->map_size - offset || HasHole(drive, offset, size))
+		return NULL;
+
+	return drive->map + offset;
+}
+
+static int IsMapped(const struct drive *drive, const uint8_t *buf)
+{
+	return drive->map && buf >= drive->map && buf < drive->map + drive->map_size;
+}
+
+// Write the pages of 'buf' which differ from the shared mapping of the drive
+// at 'dst', so unchanged pages aren't written back. The mapping is only read;
+// storing through it would turn a write error into SIGBUS.
+static int SaveMapped(struct drive *drive, const uint8_t *dst, const uint8_t *buf,
+		      size_t count)
+{
+	uintptr_t page_size = sysconf(_SC_PAGESIZE);
+	off_t file_offset = dst - drive->shared_map;
+	size_t offset = 0;
+
+	while (offset < count) {
+		size_t chunk = page_size - ((uintptr_t)(dst + offset) & (page_size - 1));
+
+		if (chunk > count - offset)
+			chunk = count - offset;
+		if (memcmp(dst + offset, buf + offset, chunk) &&
+		    pwrite(drive->fd, buf + offset, chunk, file_offset + offset) !=
+			    (ssize_t)chunk)
+			return CGPT_FAILED;
+		offset += chunk;
+	}
+
+	return CGPT_OK;
+}
+
 int Save(struct drive *drive, const uint8_t *buf, const uint64_t sector,
 	 const uint64_t sector_bytes, const uint64_t sector_count)
 {
@@ -151,16 +208,38 @@ int Save(struct drive *drive, const uint8_t *buf, const uint64_t sector,
 	require(buf);
 	count = sector_bytes * sector_count;
 
-	if (-1 == lseek(drive->fd, sector * sector_bytes, SEEK_SET))
-		return CGPT_FAILED;
+	uint8_t *mapped = MappedSectors(drive, sector, count);
+	if (mapped && drive->shared_map)
+		return SaveMapped(drive, drive->shared_map + (mapped - drive->map), buf,
+				  count);
 
-	nwrote = write(drive->fd, buf, count);
+	nwrote = pwrite(drive->fd, buf, count, sector * sector_bytes);
 	if (nwrote < count)
 		return CGPT_FAILED;
 
 	return CGPT_OK;
 }
 
+// Point '*buf' at 'sector_count' sectors of the drive starting at 'sector'.
+// The GPT code may use all 'alloc_size' bytes of the buffer. If the drive is
+// mapped and has that many bytes there, the buffer is the mapping itself;
+// otherwise it's allocated and read in.
+static int LoadGptBuffer(struct drive *drive, uint8_t **buf, uint64_t sector,
+			 uint64_t sector_count, size_t alloc_size)
+{
+	if (sector_count * drive->gpt.sector_bytes <= alloc_size) {
+		*buf = MappedSectors(drive, sector, alloc_size);
+		if (*buf)
+			return CGPT_OK;
+	}
+
+	*buf = malloc(alloc_size);
+	if (!*buf)
+		return CGPT_FAILED;
+
+	return Load(drive, *buf, sector, drive->gpt.sector_bytes, sector_count);
+}
+
 static int GptLoad(struct drive *drive, uint32_t sector_bytes)
 {
 	drive->gpt.sector_bytes = sector_bytes;
@@ -171,28 +250,20 @@ static int GptLoad(struct drive *drive, uint32_t sector_bytes)
 	}
 	drive->gpt.streaming_drive_sectors = drive->size / drive->gpt.sector_bytes;
 
-	drive->gpt.primary_header = malloc(drive->gpt.sector_bytes);
-	drive->gpt.secondary_header = malloc(drive->gpt.sector_bytes);
-	drive->gpt.primary_entries = malloc(GPT_ENTRIES_ALLOC_SIZE);
-	drive->gpt.secondary_entries = malloc(GPT_ENTRIES_ALLOC_SIZE);
-	if (!drive->gpt.primary_header || !drive->gpt.secondary_header ||
-	    !drive->gpt.primary_entries || !drive->gpt.secondary_entries)
-		return -1;
-
 	/* TODO(namnguyen): Remove this and totally trust gpt_drive_sectors. */
 	if (!(drive->gpt.flags & GPT_FLAG_EXTERNAL)) {
 		drive->gpt.gpt_drive_sectors = drive->gpt.streaming_drive_sectors;
 	} /* Else, we trust gpt.gpt_drive_sectors. */
 
 	// Read the data.
-	if (CGPT_OK != Load(drive, drive->gpt.primary_header, GPT_PMBR_SECTORS,
-			    drive->gpt.sector_bytes, GPT_HEADER_SECTORS)) {
+	if (CGPT_OK != LoadGptBuffer(drive, &drive->gpt.primary_header, GPT_PMBR_SECTORS,
+				     GPT_HEADER_SECTORS, drive->gpt.sector_bytes)) {
 		Error("Cannot read primary GPT header\n");
 		return -1;
 	}
-	if (CGPT_OK != Load(drive, drive->gpt.secondary_header,
-			    drive->gpt.gpt_drive_sectors - GPT_PMBR_SECTORS,
-			    drive->gpt.sector_bytes, GPT_HEADER_SECTORS)) {
+	if (CGPT_OK != LoadGptBuffer(drive, &drive->gpt.secondary_header,
+				     drive->gpt.gpt_drive_sectors - GPT_PMBR_SECTORS,
+				     GPT_HEADER_SECTORS, drive->gpt.sector_bytes)) {
 		Error("Cannot read secondary GPT header\n");
 		return -1;
 	}
@@ -201,13 +272,16 @@ static int GptLoad(struct drive *drive, uint32_t sector_bytes)
 			drive->gpt.gpt_drive_sectors, drive->gpt.flags,
 			drive->gpt.sector_bytes) == 0) {
 		if (CGPT_OK !=
-		    Load(drive, drive->gpt.primary_entries, primary_header->entries_lba,
-			 drive->gpt.sector_bytes,
-			 CalculateEntriesSectors(primary_header, drive->gpt.sector_bytes))) {
+		    LoadGptBuffer(drive, &drive->gpt.primary_entries, primary_header->entries_lba,
+				  CalculateEntriesSectors(primary_header, drive->gpt.sector_bytes),
+				  GPT_ENTRIES_ALLOC_SIZE)) {
 			Error("Cannot read primary partition entry array\n");
 			return -1;
 		}
 	} else {
+		drive->gpt.primary_entries = malloc(GPT_ENTRIES_ALLOC_SIZE);
+		if (!drive->gpt.primary_entries)
+			return -1;
 		Warning("Primary GPT header is %s\n",
 			memcmp(primary_header->signature, GPT_HEADER_SIGNATURE_IGNORED,
 			       GPT_HEADER_SIGNATURE_SIZE)
@@ -219,13 +293,17 @@ static int GptLoad(struct drive *drive, uint32_t sector_bytes)
 			drive->gpt.gpt_drive_sectors, drive->gpt.flags,
 			drive->gpt.sector_bytes) == 0) {
 		if (CGPT_OK !=
-		    Load(drive, drive->gpt.secondary_entries, secondary_header->entries_lba,
-			 drive->gpt.sector_bytes,
-			 CalculateEntriesSectors(secondary_header, drive->gpt.sector_bytes))) {
+		    LoadGptBuffer(drive, &drive->gpt.secondary_entries,
+				  secondary_header->entries_lba,
+				  CalculateEntriesSectors(secondary_header, drive->gpt.sector_bytes),
+				  GPT_ENTRIES_ALLOC_SIZE)) {
 			Error("Cannot read secondary partition entry array\n");
 			return -1;
 		}
 	} else {
+		drive->gpt.secondary_entries = malloc(GPT_ENTRIES_ALLOC_SIZE);
+		if (!drive->gpt.secondary_entries)
+			return -1;
 		Warning("Secondary GPT header is %s\n",
 			memcmp(primary_header->signature, GPT_HEADER_SIGNATURE_IGNORED,
 			       GPT_HEADER_SIGNATURE_SIZE)
@@ -235,6 +313,26 @@ static int GptLoad(struct drive *drive, uint32_t sector_bytes)
 	return 0;
 }
 
+// Write the entry array described by 'header', or if the GPT knows which
+// entries changed, just the sectors holding those.
+static int SaveEntries(struct drive *drive, GptHeader *header, uint8_t *entries)
+{
+	uint32_t sector_bytes = drive->gpt.sector_bytes;
+	uint64_t first = 0;
+	uint64_t count = CalculateEntriesSectors(header, sector_bytes);
+
+	if (drive->gpt.dirty_entries_end) {
+		uint64_t start = (uint64_t)drive->gpt.dirty_entries_start * header->size_of_entry;
+		uint64_t end = (uint64_t)drive->gpt.dirty_entries_end * header->size_of_entry;
+
+		first = start / sector_bytes;
+		count = (end + sector_bytes - 1) / sector_bytes - first;
+	}
+
+	return Save(drive, entries + first * sector_bytes, header->entries_lba + first,
+		    sector_bytes, count);
+}
+
 static int GptSave(struct drive *drive)
 {
 	int errors = 0;
@@ -249,11 +347,8 @@ static int GptSave(struct drive *drive)
 		}
 		GptHeader *primary_header = (GptHeader *)drive->gpt.primary_header;
 		if (drive->gpt.modified & GPT_MODIFIED_ENTRIES1) {
-			if (CGPT_OK != Save(drive, drive->gpt.primary_entries,
-					    primary_header->entries_lba,
-					    drive->gpt.sector_bytes,
-					    CalculateEntriesSectors(primary_header,
-								    drive->gpt.sector_bytes))) {
+			if (CGPT_OK != SaveEntries(drive, primary_header,
+						   drive->gpt.primary_entries)) {
 				errors++;
 				Error("Cannot write primary entries: %s\n", strerror(errno));
 			}
@@ -279,11 +374,8 @@ static int GptSave(struct drive *drive)
 		}
 		GptHeader *secondary_header = (GptHeader *)drive->gpt.secondary_header;
 		if (drive->gpt.modified & GPT_MODIFIED_ENTRIES2) {
-			if (CGPT_OK != Save(drive, drive->gpt.secondary_entries,
-					    secondary_header->entries_lba,
-					    drive->gpt.sector_bytes,
-					    CalculateEntriesSectors(secondary_header,
-								    drive->gpt.sector_bytes))) {
+			if (CGPT_OK != SaveEntries(drive, secondary_header,
+						   drive->gpt.secondary_entries)) {
 				errors++;
 				Error("Cannot write secondary entries: %s\n", strerror(errno));
 			}
@@ -322,6 +414,34 @@ static int ObtainDriveSize(int fd, uint64_t *size, uint32_t *sector_bytes)
 	return 0;
 }
 
+// Map a drive that's a regular file, such as a disk image, so GptLoad() can
+// use the GPT in place instead of reading a copy. The GPT buffers point into
+// a private mapping, so changes stay in memory until GptSave() writes the
+// pages which differ from a read-only shared mapping of the file. If mapping
+// fails, the drive is read and written as usual.
+static void MapDrive(struct drive *drive, int mode, uint64_t size)
+{
+	struct stat stat;
+
+	if (fstat(drive->fd, &stat) == -1 || !S_ISREG(stat.st_mode) || !size ||
+	    size != (size_t)size)
+		return;
+
+	drive->map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, drive->fd, 0);
+	if (drive->map == MAP_FAILED) {
+		drive->map = NULL;
+		return;
+	}
+	drive->map_size = size;
+
+	if ((mode & O_ACCMODE) == O_RDWR) {
+		drive->shared_map =
+			mmap(NULL, size, PROT_READ, MAP_SHARED, drive->fd, 0);
+		if (drive->shared_map == MAP_FAILED)
+			drive->shared_map = NULL;
+	}
+}
+
 int DriveOpen(const char *drive_path, struct drive *drive, int mode, uint64_t drive_size)
 {
 	uint32_t sector_bytes;
@@ -358,6 +478,8 @@ int DriveOpen(const char *drive_path, struct drive *drive, int mode, uint64_t dr
 		drive->gpt.flags = GPT_FLAG_EXTERNAL;
 	}
 
+	MapDrive(drive, mode, gpt_drive_size);
+
 	if (GptLoad(drive, sector_bytes)) {
 		goto error_close;
 	}
@@ -380,15 +502,25 @@ int DriveClose(struct drive *drive, int update_as_needed)
 		}
 	}
 
-	free(drive->gpt.primary_header);
+	if (!IsMapped(drive, drive->gpt.primary_header))
+		free(drive->gpt.primary_header);
 	drive->gpt.primary_header = NULL;
-	free(drive->gpt.primary_entries);
+	if (!IsMapped(drive, drive->gpt.primary_entries))
+		free(drive->gpt.primary_entries);
 	drive->gpt.primary_entries = NULL;
-	free(drive->gpt.secondary_header);
+	if (!IsMapped(drive, drive->gpt.secondary_header))
+		free(drive->gpt.secondary_header);
 	drive->gpt.secondary_header = NULL;
-	free(drive->gpt.secondary_entries);
+	if (!IsMapped(drive, drive->gpt.secondary_entries))
+		free(drive->gpt.secondary_entries);
 	drive->gpt.secondary_entries = NULL;
 
+	if (drive->map)
+		munmap(drive->map, drive->map_size);
+	if (drive->shared_map)
+		munmap(drive->shared_map, drive->map_size);
+	drive->map = drive->shared_map = NULL;
+
 	// Sync early! Only sync file descriptor here, and leave the whole system sync
 	// outside cgpt because whole system sync would trigger tons of disk accesses
 	// and timeout tests.
@@ -858,11 +990,19 @@ void SetRaw(struct drive *drive, int secondary, uint32_t entry_index, uint32_t r
 
 void UpdateAllEntries(struct drive *drive)
 {
+	GptHeader *header = (GptHeader *)drive->gpt.primary_header;
+
+	// If the secondary GPT still matches the old primary, only the entries
+	// which changed need their CRCs updated and writing back.
+	if (GPT_SUCCESS == GptEntriesModified(&drive->gpt, 0, header->number_of_entries))
+		return;
+
 	RepairEntries(&drive->gpt, MASK_PRIMARY);
 	RepairHeader(&drive->gpt, MASK_PRIMARY);
 
 	drive->gpt.modified |= (GPT_MODIFIED_HEADER1 | GPT_MODIFIED_ENTRIES1 |
 				GPT_MODIFIED_HEADER2 | GPT_MODIFIED_ENTRIES2);
+	drive->gpt.dirty_entries_end = 0;
 	UpdateCrc(&drive->gpt);
 }
 
@@ -8,10 +8,25 @@
 #include "cgpt_params.h"
 #include "vboot_host.h"
 
+int CgptEditOnDrive(struct drive *drive, CgptEditParams *params)
+{
+	GptHeader *h = (GptHeader *)drive->gpt.primary_header;
+
+	if (params->set_unique) {
+		memcpy(&h->disk_uuid, &params->unique_guid, sizeof(h->disk_uuid));
+	}
+	// Copy to secondary
+	RepairHeader(&drive->gpt, MASK_PRIMARY);
+	drive->gpt.modified |= (GPT_MODIFIED_HEADER1 | GPT_MODIFIED_HEADER2);
+
+	UpdateCrc(&drive->gpt);
+
+	return CGPT_OK;
+}
+
 int CgptEdit(CgptEditParams *params)
 {
 	struct drive drive;
-	GptHeader *h;
 	int gpt_retval;
 
 	if (params == NULL)
@@ -30,15 +45,7 @@ int CgptEdit(CgptEditParams *params)
 		goto bad;
 	}
 
-	h = (GptHeader *)drive.gpt.primary_header;
-	if (params->set_unique) {
-		memcpy(&h->disk_uuid, &params->unique_guid, sizeof(h->disk_uuid));
-	}
-	// Copy to secondary
-	RepairHeader(&drive.gpt, MASK_PRIMARY);
-	drive.gpt.modified |= (GPT_MODIFIED_HEADER1 | GPT_MODIFIED_HEADER2);
-
-	UpdateCrc(&drive.gpt);
+	CgptEditOnDrive(&drive, params);
 
 	// Write it all out.
 	return DriveClose(&drive, 1);
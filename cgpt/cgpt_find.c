@@ -4,6 +4,7 @@
  */
 
 #include <ctype.h>
+#include <pthread.h>
 #include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -16,29 +17,40 @@
 
 #define BUFSIZE 1024
 
-// fill comparebuf with the data to be examined, returning true on success.
-static int FillBuffer(CgptFindParams *params, int fd, uint64_t pos, uint64_t count)
+// A drive to search, and the matches found on it. The matching entries are
+// copied out so the drive can be closed before they're shown.
+struct find_hit {
+	int partnum;
+	GptEntry entry;
+};
+
+struct find_job {
+	const char *filename;
+	struct find_hit *hits;
+	int num_hits;
+	int done;
+};
+
+// fill buf with the data to be examined, returning true on success.
+static int FillBuffer(uint8_t *buf, int fd, uint64_t pos, uint64_t count)
 {
-	uint8_t *bufptr = params->comparebuf;
-
-	if (-1 == lseek(fd, pos, SEEK_SET))
-		return 0;
-
 	// keep reading until done or error
 	while (count) {
-		ssize_t bytes_read = read(fd, bufptr, count);
+		ssize_t bytes_read = pread(fd, buf, count, pos);
 		// negative means error, 0 means (unexpected) EOF
 		if (bytes_read <= 0)
 			return 0;
 		count -= bytes_read;
-		bufptr += bytes_read;
+		buf += bytes_read;
+		pos += bytes_read;
 	}
 
 	return 1;
 }
 
 // check partition data content. return true for match, 0 for no match or error
-static int match_content(CgptFindParams *params, struct drive *drive, GptEntry *entry)
+static int match_content(const CgptFindParams *params, struct drive *drive,
+			 GptEntry *entry, uint8_t *comparebuf)
 {
 	uint64_t part_size;
 
@@ -52,7 +64,7 @@ static int match_content(CgptFindParams *params, struct drive *drive, GptEntry *
 	}
 
 	// Read the partition data.
-	if (!FillBuffer(params, drive->fd,
+	if (!FillBuffer(comparebuf, drive->fd,
 			(drive->gpt.sector_bytes * entry->starting_lba) + params->matchoffset,
 			params->matchlen)) {
 		Error("unable to read partition data\n");
@@ -60,7 +72,7 @@ static int match_content(CgptFindParams *params, struct drive *drive, GptEntry *
 	}
 
 	// Compare it
-	if (0 == memcmp(params->matchbuf, params->comparebuf, params->matchlen)) {
+	if (0 == memcmp(params->matchbuf, comparebuf, params->matchlen)) {
 		return 1;
 	}
 
@@ -96,19 +108,18 @@ static void showmatch(CgptFindParams *params, const char *filename, int partnum,
 		EntryDetails(entry, partnum - 1, params->numeric);
 }
 
-// This returns true if a GPT partition matches the search criteria. If a match
-// isn't found (or if the file doesn't contain a GPT), it returns false. The
-// filename and partition number that matched is left in a global, since we
-// could have multiple hits.
-static int gpt_search(CgptFindParams *params, struct drive *drive, const char *filename)
+// This records in 'job' every GPT partition that matches the search criteria.
+// Nothing is recorded if the file doesn't contain a GPT. It doesn't print or
+// touch 'params', so several drives can be searched at once.
+static void gpt_search(const CgptFindParams *params, struct drive *drive,
+		       uint8_t *comparebuf, struct find_job *job)
 {
 	int i;
 	GptEntry *entry;
-	int retval = 0;
 	char partlabel[GPT_PARTNAME_LEN];
 
 	if (GPT_SUCCESS != GptValidityCheck(&drive->gpt)) {
-		return 0;
+		return;
 	}
 
 	for (i = 0; i < GetNumberOfEntries(drive); ++i) {
@@ -126,38 +137,185 @@ static int gpt_search(CgptFindParams *params, struct drive *drive, const char *f
 						   sizeof(entry->name) / sizeof(entry->name[0]),
 						   (uint8_t *)partlabel, sizeof(partlabel))) {
 				Error("The label cannot be converted from UTF16, so abort.\n");
-				return 0;
+				return;
 			}
 			if (!strncmp(params->label, partlabel, sizeof(partlabel)))
 				found = 1;
 		}
-		if (found && match_content(params, drive, entry)) {
-			params->hits++;
-			retval++;
-			showmatch(params, filename, i + 1, entry);
-			if (!params->match_partnum)
-				params->match_partnum = i + 1;
+		if (found && match_content(params, drive, entry, comparebuf)) {
+			if (!job->hits) {
+				job->hits = calloc(GetNumberOfEntries(drive),
+						   sizeof(*job->hits));
+				if (!job->hits) {
+					Error("Unable to allocate matches for %s\n",
+					      job->filename);
+					return;
+				}
+			}
+			job->hits[job->num_hits].partnum = i + 1;
+			memcpy(&job->hits[job->num_hits].entry, entry, sizeof(*entry));
+			job->num_hits++;
 		}
 	}
-
-	return retval;
 }
 
-static int do_search(CgptFindParams *params, const char *fileName)
+static void search_drive(const CgptFindParams *params, uint8_t *comparebuf,
+			 struct find_job *job)
 {
-	int retval;
 	struct drive drive;
 
-	if (CGPT_OK != DriveOpen(fileName, &drive, O_RDONLY, params->drive_size))
-		return 0;
+	if (CGPT_OK != DriveOpen(job->filename, &drive, O_RDONLY, params->drive_size))
+		return;
 
-	retval = gpt_search(params, &drive, fileName);
+	gpt_search(params, &drive, comparebuf, job);
 
 	(void)DriveClose(&drive, 0);
+}
+
+// Show the matches found by search_drive(). Returns the number of matches.
+static int report_job(CgptFindParams *params, struct find_job *job)
+{
+	int retval = job->num_hits;
+	int i;
+
+	for (i = 0; i < job->num_hits; i++) {
+		params->hits++;
+		showmatch(params, job->filename, job->hits[i].partnum,
+			  &job->hits[i].entry);
+		if (!params->match_partnum)
+			params->match_partnum = job->hits[i].partnum;
+	}
+
+	free(job->hits);
+	job->hits = NULL;
+	job->num_hits = 0;
 
 	return retval;
 }
 
+static int do_search(CgptFindParams *params, const char *fileName)
+{
+	struct find_job job = {
+		.filename = fileName,
+	};
+
+	search_drive(params, params->comparebuf, &job);
+
+	return report_job(params, &job);
+}
+
+struct find_pool {
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	const CgptFindParams *params;
+	struct find_job *jobs;
+	int num_jobs;
+	// Next job for a worker to take
+	int next;
+};
+
+struct find_worker {
+	pthread_t thread;
+	struct find_pool *pool;
+	uint8_t *comparebuf;
+};
+
+static void *find_worker_main(void *arg)
+{
+	struct find_worker *worker = arg;
+	struct find_pool *pool = worker->pool;
+	int i;
+
+	while (1) {
+		pthread_mutex_lock(&pool->lock);
+		i = pool->next++;
+		pthread_mutex_unlock(&pool->lock);
+		if (i >= pool->num_jobs)
+			break;
+
+		search_drive(pool->params, worker->comparebuf, &pool->jobs[i]);
+
+		pthread_mutex_lock(&pool->lock);
+		pool->jobs[i].done = 1;
+		pthread_cond_broadcast(&pool->cond);
+		pthread_mutex_unlock(&pool->lock);
+	}
+
+	return NULL;
+}
+
+// Search several drives, up to params->jobs of them at once. Matches are
+// shown in the order of 'filenames', same as searching them one by one.
+// Returns the number of drives with matches.
+static int search_drives(CgptFindParams *params, const char *const filenames[],
+			 int count)
+{
+	struct find_pool pool = {
+		.lock = PTHREAD_MUTEX_INITIALIZER,
+		.cond = PTHREAD_COND_INITIALIZER,
+		.params = params,
+		.num_jobs = count,
+	};
+	struct find_worker *workers = NULL;
+	uint8_t *comparebufs = NULL;
+	int num_workers = params->jobs < count ? params->jobs : count;
+	int started = 0;
+	int found = 0;
+	int i;
+
+	if (num_workers > 1) {
+		pool.jobs = calloc(count, sizeof(*pool.jobs));
+		workers = calloc(num_workers, sizeof(*workers));
+		if (params->matchlen)
+			comparebufs = malloc(num_workers * params->matchlen);
+	}
+	if (!pool.jobs || !workers || (params->matchlen && !comparebufs)) {
+		// Nothing to overlap, or not enough memory to try.
+		free(pool.jobs);
+		free(workers);
+		free(comparebufs);
+		for (i = 0; i < count; i++) {
+			if (do_search(params, filenames[i]))
+				found++;
+		}
+		return found;
+	}
+
+	for (i = 0; i < count; i++)
+		pool.jobs[i].filename = filenames[i];
+
+	for (i = 0; i < num_workers; i++) {
+		workers[i].pool = &pool;
+		if (comparebufs)
+			workers[i].comparebuf = comparebufs + i * params->matchlen;
+		if (pthread_create(&workers[i].thread, NULL, find_worker_main,
+				   &workers[i]))
+			break;
+		started++;
+	}
+	// Do all the work here if no thread could be started.
+	if (!started)
+		find_worker_main(&workers[0]);
+
+	for (i = 0; i < count; i++) {
+		pthread_mutex_lock(&pool.lock);
+		while (!pool.jobs[i].done)
+			pthread_cond_wait(&pool.cond, &pool.lock);
+		pthread_mutex_unlock(&pool.lock);
+
+		if (report_job(params, &pool.jobs[i]))
+			found++;
+	}
+
+	for (i = 0; i < started; i++)
+		pthread_join(workers[i].thread, NULL);
+
+	free(pool.jobs);
+	free(workers);
+	free(comparebufs);
+	return found;
+}
+
 #define PROC_MTD "/proc/mtd"
 #define PROC_PARTITIONS "/proc/partitions"
 #define DEV_DIR "/dev"
@@ -287,6 +445,9 @@ static int scan_real_devs(CgptFindParams *params)
 	char partname_prev[MAX_PARTITION_NAME_LEN];
 	FILE *fp;
 	char *pathname;
+	char **devs = NULL;
+	int num_devs = 0;
+	int i;
 
 	fp = fopen(PROC_PARTITIONS, "re");
 	if (!fp) {
@@ -310,8 +471,12 @@ static int scan_real_devs(CgptFindParams *params)
 		if (!strncmp(partname_prev, partname, strlen(partname_prev)) &&
 		    strlen(partname_prev)) {
 			if ((pathname = is_wholedev(partname_prev))) {
-				if (do_search(params, pathname)) {
-					found++;
+				char **new_devs = realloc(devs, (num_devs + 1) * sizeof(*devs));
+				if (new_devs) {
+					devs = new_devs;
+					devs[num_devs] = strdup(pathname);
+					if (devs[num_devs])
+						num_devs++;
 				}
 			}
 		}
@@ -322,6 +487,13 @@ static int scan_real_devs(CgptFindParams *params)
 	fclose(fp);
 	free(line);
 
+	// Search only once /proc/partitions has been read, so the drives can be
+	// searched in parallel.
+	found += search_drives(params, (const char *const *)devs, num_devs);
+	for (i = 0; i < num_devs; i++)
+		free(devs[i]);
+	free(devs);
+
 	found += scan_spi_gpt(params);
 
 	return found;
@@ -337,3 +509,12 @@ void CgptFind(CgptFindParams *params)
 	else
 		scan_real_devs(params);
 }
+
+void CgptFindDrives(CgptFindParams *params, const char *const drive_names[],
+		    int count)
+{
+	if (params == NULL)
+		return;
+
+	search_drives(params, drive_names, count);
+}
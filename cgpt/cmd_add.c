@@ -152,6 +152,14 @@ int cmd_add(int argc, char *argv[])
 		return CGPT_FAILED;
 	}
 
+	if (batch_drive) {
+		if (optind < argc) {
+			Error("DRIVE is given to 'cgpt batch', not on each line\n");
+			return CGPT_FAILED;
+		}
+		return CgptAddOnDrive(batch_drive, &params);
+	}
+
 	if (optind >= argc) {
 		Error("missing drive argument\n");
 		return CGPT_FAILED;
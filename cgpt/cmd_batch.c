@@ -0,0 +1,256 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include <ctype.h>
+#include <errno.h>
+#include <getopt.h>
+#include <string.h>
+
+#include "cgpt.h"
+#include "cgptlib_internal.h"
+#include "vboot_host.h"
+
+extern const char *progname;
+
+struct drive *batch_drive;
+
+// Most words a single script line may have, including the command.
+#define BATCH_MAX_ARGS 64
+
+static const struct {
+	const char *name;
+	int (*fp)(int argc, char *argv[]);
+} batch_cmds[] = {
+	{"add", cmd_add},
+	{"boot", cmd_boot},
+	{"edit", cmd_edit},
+	{"prioritize", cmd_prioritize},
+};
+
+static void Usage(void)
+{
+	printf("\nUsage: %s batch [OPTIONS] DRIVE\n\n"
+	       "Run several commands against DRIVE, writing it only once.\n\n"
+	       "Options:\n"
+	       "  -D NUM       Size (in bytes) of the disk where partitions reside;\n"
+	       "                 default 0, meaning partitions and GPT structs are\n"
+	       "                 both on DRIVE\n"
+	       "  -f FILE      Read commands from FILE (default is stdin)\n"
+	       "\n"
+	       "Each line of the script is one add, boot, edit or prioritize\n"
+	       "command with its options but without the DRIVE argument, e.g.\n"
+	       "\n"
+	       "    add -i 2 -t kernel -l \"KERN-A\" -b 64 -s 1024\n"
+	       "    prioritize -i 2\n"
+	       "\n"
+	       "Words may be quoted with ' or \". Blank lines and lines starting\n"
+	       "with # are ignored. The GPT is loaded and validated once. If any\n"
+	       "command fails, nothing is written to DRIVE.\n"
+	       "\n",
+	       progname);
+}
+
+// Split 'line' into words in place. Returns the number of words, or -1 if
+// there are too many or a quote isn't closed.
+static int SplitLine(char *line, char *argv[], int max_args)
+{
+	char *in = line;
+	char *out = line;
+	int argc = 0;
+
+	while (1) {
+		char quote = 0;
+
+		while (isspace((unsigned char)*in))
+			in++;
+		if (!*in || *in == '#')
+			break;
+		if (argc >= max_args)
+			return -1;
+
+		argv[argc++] = out;
+		while (*in && (quote || !isspace((unsigned char)*in))) {
+			if (quote && *in == quote)
+				quote = 0;
+			else if (!quote && (*in == '"' || *in == '\''))
+				quote = *in;
+			else
+				*out++ = *in;
+			in++;
+		}
+		if (quote)
+			return -1;
+		// 'out' never gets ahead of 'in', so this can't clobber input
+		if (*in)
+			in++;
+		*out++ = '\0';
+	}
+
+	return argc;
+}
+
+static int RunLine(char *line)
+{
+	char *argv[BATCH_MAX_ARGS + 1];
+	int argc;
+	int i;
+
+	argc = SplitLine(line, argv, BATCH_MAX_ARGS);
+	if (argc < 0) {
+		Error("too many words or unterminated quote\n");
+		return CGPT_FAILED;
+	}
+	if (argc == 0)
+		return CGPT_OK;
+	argv[argc] = NULL;
+
+	for (i = 0; i < ARRAY_COUNT(batch_cmds); i++) {
+		if (!strcmp(batch_cmds[i].name, argv[0])) {
+			// Reset so the command can parse its own options
+			optind = 0;
+			return batch_cmds[i].fp(argc, argv);
+		}
+	}
+
+	Error("unsupported batch command: %s\n", argv[0]);
+	return CGPT_FAILED;
+}
+
+static int RunScript(struct drive *drive, FILE *fp, const char *script_name)
+{
+	char *line = NULL;
+	size_t line_size = 0;
+	int lineno = 0;
+	int retval = CGPT_OK;
+
+	batch_drive = drive;
+	while (getline(&line, &line_size, fp) != -1) {
+		lineno++;
+		if (CGPT_OK != RunLine(line)) {
+			Error("%s:%d: command failed, nothing written\n",
+			      script_name, lineno);
+			retval = CGPT_FAILED;
+			break;
+		}
+	}
+	if (retval == CGPT_OK && ferror(fp)) {
+		Error("Can't read %s: %s\n", script_name, strerror(errno));
+		retval = CGPT_FAILED;
+	}
+	batch_drive = NULL;
+
+	free(line);
+	return retval;
+}
+
+static int RunBatch(const char *drive_name, uint64_t drive_size, FILE *fp,
+		    const char *script_name)
+{
+	struct drive drive;
+	struct pmbr orig_pmbr;
+	int gpt_retval;
+
+	if (CGPT_OK != DriveOpen(drive_name, &drive, O_RDWR, drive_size))
+		return CGPT_FAILED;
+
+	if (GPT_SUCCESS != (gpt_retval = GptValidityCheck(&drive.gpt))) {
+		Error("GptValidityCheck() returned %d: %s\n", gpt_retval,
+		      GptError(gpt_retval));
+		goto bad;
+	}
+
+	if (CGPT_OK != CheckValid(&drive)) {
+		Error("please run 'cgpt repair' before running a batch.\n");
+		goto bad;
+	}
+
+	if (CGPT_OK != ReadPMBR(&drive)) {
+		Error("Unable to read PMBR\n");
+		goto bad;
+	}
+	memcpy(&orig_pmbr, &drive.pmbr, sizeof(orig_pmbr));
+
+	if (CGPT_OK != RunScript(&drive, fp, script_name))
+		goto bad;
+
+	if (memcmp(&orig_pmbr, &drive.pmbr, sizeof(orig_pmbr)) &&
+	    CGPT_OK != WritePMBR(&drive)) {
+		Error("Unable to write PMBR\n");
+		goto bad;
+	}
+
+	// Write out whatever the script touched, each part once.
+	return DriveClose(&drive, 1);
+
+bad:
+	(void)DriveClose(&drive, 0);
+	return CGPT_FAILED;
+}
+
+int cmd_batch(int argc, char *argv[])
+{
+	const char *script_name = NULL;
+	uint64_t drive_size = 0;
+	FILE *fp = stdin;
+	int retval;
+
+	int c;
+	char *e = 0;
+	int errorcnt = 0;
+
+	opterr = 0; // quiet, you
+	while ((c = getopt(argc, argv, ":hf:D:")) != -1) {
+		switch (c) {
+		case 'D':
+			drive_size = strtoull(optarg, &e, 0);
+			errorcnt += check_int_parse(c, e);
+			break;
+		case 'f':
+			script_name = optarg;
+			break;
+
+		case 'h':
+			Usage();
+			return CGPT_OK;
+		case '?':
+			Error("unrecognized option: -%c\n", optopt);
+			errorcnt++;
+			break;
+		case ':':
+			Error("missing argument to -%c\n", optopt);
+			errorcnt++;
+			break;
+		default:
+			errorcnt++;
+			break;
+		}
+	}
+	if (errorcnt) {
+		Usage();
+		return CGPT_FAILED;
+	}
+
+	if (optind >= argc) {
+		Error("missing drive argument\n");
+		return CGPT_FAILED;
+	}
+
+	if (script_name && strcmp(script_name, "-")) {
+		fp = fopen(script_name, "r");
+		if (!fp) {
+			Error("Can't open %s: %s\n", script_name, strerror(errno));
+			return CGPT_FAILED;
+		}
+	} else {
+		script_name = "<stdin>";
+	}
+
+	retval = RunBatch(argv[optind], drive_size, fp, script_name);
+
+	if (fp != stdin)
+		fclose(fp);
+
+	return retval;
+}
@@ -68,17 +68,25 @@ int cmd_edit(int argc, char *argv[])
 		return CGPT_FAILED;
 	}
 
-	if (optind >= argc) {
-		Error("missing drive argument\n");
+	if (!params.set_unique) {
+		Error("no parameters were edited\n");
 		return CGPT_FAILED;
 	}
 
-	params.drive_name = argv[optind];
+	if (batch_drive) {
+		if (optind < argc) {
+			Error("DRIVE is given to 'cgpt batch', not on each line\n");
+			return CGPT_FAILED;
+		}
+		return CgptEditOnDrive(batch_drive, &params);
+	}
 
-	if (!params.set_unique) {
-		Error("no parameters were edited\n");
+	if (optind >= argc) {
+		Error("missing drive argument\n");
 		return CGPT_FAILED;
 	}
 
+	params.drive_name = argv[optind];
+
 	return CgptEdit(&params);
 }
@@ -26,6 +26,7 @@ static void Usage(void)
 	       "  -v           Be verbose in displaying matches (repeatable)\n"
 	       "  -n           Numeric output only\n"
 	       "  -1           Fail if more than one match is found\n"
+	       "  -j NUM       Search up to NUM drives at once (default 1)\n"
 	       "  -M FILE"
 	       "      Matching partition data must also contain FILE content\n"
 	       "  -O NUM"
@@ -78,13 +79,12 @@ int cmd_find(int argc, char *argv[])
 	CgptFindParams params;
 	memset(&params, 0, sizeof(params));
 
-	int i;
 	int errorcnt = 0;
 	char *e = 0;
 	int c;
 
 	opterr = 0; // quiet, you
-	while ((c = getopt(argc, argv, ":hv1nt:u:l:M:O:D:")) != -1) {
+	while ((c = getopt(argc, argv, ":hv1nj:t:u:l:M:O:D:")) != -1) {
 		switch (c) {
 		case 'D':
 			params.drive_size = strtoull(optarg, &e, 0);
@@ -99,6 +99,11 @@ int cmd_find(int argc, char *argv[])
 		case '1':
 			params.oneonly = 1;
 			break;
+		case 'j':
+			params.jobs = (int)strtol(optarg, &e, 0);
+			errorcnt += check_int_parse(c, e);
+			errorcnt += check_int_limit(c, params.jobs, 1, 256);
+			break;
 		case 'l':
 			params.set_label = 1;
 			params.label = optarg;
@@ -164,10 +169,8 @@ int cmd_find(int argc, char *argv[])
 	}
 
 	if (optind < argc) {
-		for (i = optind; i < argc; i++) {
-			params.drive_name = argv[i];
-			CgptFind(&params);
-		}
+		CgptFindDrives(&params, (const char *const *)&argv[optind],
+			       argc - optind);
 	} else {
 		CgptFind(&params);
 	}
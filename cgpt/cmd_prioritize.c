@@ -95,6 +95,14 @@ int cmd_prioritize(int argc, char *argv[])
 		return CGPT_FAILED;
 	}
 
+	if (batch_drive) {
+		if (optind < argc) {
+			Error("DRIVE is given to 'cgpt batch', not on each line\n");
+			return CGPT_FAILED;
+		}
+		return CgptPrioritizeOnDrive(batch_drive, &params);
+	}
+
 	if (optind >= argc) {
 		Error("missing drive argument\n");
 		return CGPT_FAILED;
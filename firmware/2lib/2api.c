@@ -198,6 +198,8 @@ vb2_error_t vb2api_extend_hash(struct vb2_context *ctx,
 	struct vb2_shared_data *sd = vb2_get_sd(ctx);
 	struct vb2_digest_context *dc = (struct vb2_digest_context *)
 		vb2_member_of(sd, sd->hash_offset);
+	uint32_t start_ms;
+	vb2_error_t rv;
 
 	/* Must have initialized hash digest work area */
 	if (!sd->hash_size)
@@ -209,7 +211,10 @@ vb2_error_t vb2api_extend_hash(struct vb2_context *ctx,
 
 	sd->hash_remaining_size -= size;
 
-	return vb2_digest_extend(dc, buf, size);
+	start_ms = vb2ex_mtime();
+	rv = vb2_digest_extend(dc, buf, size);
+	vb2_timing_end(ctx, VB2_TIMING_BODY_HASH, start_ms, size);
+	return rv;
 }
 
 vb2_error_t vb2api_get_pcr_digest(struct vb2_context *ctx,
@@ -348,6 +353,9 @@ vb2_error_t vb2api_check_hash_get_digest(struct vb2_context *ctx,
 	struct vb2_fw_preamble *pre;
 	struct vb2_public_key key;
 
+	uint32_t start_ms;
+	vb2_error_t rv;
+
 	vb2_workbuf_from_ctx(ctx, &wb);
 
 	/* Get preamble pointer */
@@ -395,8 +403,11 @@ vb2_error_t vb2api_check_hash_get_digest(struct vb2_context *ctx,
 	 * Check digest vs. signature.  Note that this destroys the signature.
 	 * That's ok, because we only check each signature once per boot.
 	 */
-	VB2_TRY(vb2_verify_digest(&key, &pre->body_signature, digest, &wb),
-		ctx, VB2_RECOVERY_FW_BODY);
+	start_ms = vb2ex_mtime();
+	rv = vb2_verify_digest(&key, &pre->body_signature, digest, &wb);
+	vb2_timing_end(ctx, VB2_TIMING_RSA, start_ms,
+		       pre->body_signature.sig_size);
+	VB2_TRY(rv, ctx, VB2_RECOVERY_FW_BODY);
 
 	if (digest_out != NULL) {
 		if (digest_out_size < digest_size)
@@ -148,14 +148,12 @@ vb2_error_t vb2_verify_member_inside(const void *parent, size_t parent_size,
 	return VB2_SUCCESS;
 }
 
-test_mockable
-vb2_error_t vb2_verify_digest(const struct vb2_public_key *key,
-			      struct vb2_signature *sig, const uint8_t *digest,
-			      const struct vb2_workbuf *wb)
+/**
+ * Check a signature header before verifying its data.
+ */
+static vb2_error_t check_signature(const struct vb2_public_key *key,
+				   const struct vb2_signature *sig)
 {
-	/* A signature is destroyed in the process of being verified. */
-	uint8_t *sig_data = vb2_signature_data_mutable(sig);
-
 	if (!sig->data_size)
 		return VB2_ERROR_VDATA_NOT_ENOUGH_DATA;
 
@@ -167,6 +165,19 @@ vb2_error_t vb2_verify_digest(const struct vb2_public_key *key,
 		return VB2_ERROR_VDATA_SIG_SIZE;
 	}
 
+	return VB2_SUCCESS;
+}
+
+test_mockable
+vb2_error_t vb2_verify_digest(const struct vb2_public_key *key,
+			      struct vb2_signature *sig, const uint8_t *digest,
+			      const struct vb2_workbuf *wb)
+{
+	/* A signature is destroyed in the process of being verified. */
+	uint8_t *sig_data = vb2_signature_data_mutable(sig);
+
+	VB2_TRY(check_signature(key, sig));
+
 	if (key->allow_hwcrypto) {
 		vb2_error_t rv =
 			vb2ex_hwcrypto_rsa_verify_digest(key, sig_data, digest);
@@ -187,6 +198,52 @@ vb2_error_t vb2_verify_digest(const struct vb2_public_key *key,
 	return vb2_rsa_verify_digest(key, sig_data, digest, wb);
 }
 
+vb2_error_t vb2_verify_digests(const struct vb2_public_key *key,
+			       struct vb2_signature *const sigs[],
+			       const uint8_t *const digests[], uint32_t count,
+			       vb2_error_t results[],
+			       const struct vb2_workbuf *wb)
+{
+	struct vb2_workbuf wblocal = *wb;
+	uint8_t **sig_data;
+	vb2_error_t rv = VB2_SUCCESS;
+	uint32_t i;
+
+	/* A hardware RSA engine verifies one signature at a time anyway */
+	if (key->allow_hwcrypto) {
+		for (i = 0; i < count; i++) {
+			results[i] = vb2_verify_digest(key, sigs[i],
+						       digests[i], wb);
+			if (rv == VB2_SUCCESS)
+				rv = results[i];
+		}
+		return rv;
+	}
+
+	sig_data = vb2_workbuf_alloc(&wblocal, count * sizeof(*sig_data));
+	if (!sig_data)
+		return VB2_ERROR_WORKBUF_SMALL;
+
+	/* Signatures with bad headers are skipped by passing NULL */
+	for (i = 0; i < count; i++) {
+		sig_data[i] = NULL;
+		if (check_signature(key, sigs[i]) == VB2_SUCCESS)
+			sig_data[i] = vb2_signature_data_mutable(sigs[i]);
+	}
+
+	vb2_rsa_verify_digests(key, sig_data, digests, count, results,
+			       &wblocal);
+
+	for (i = 0; i < count; i++) {
+		if (!sig_data[i])
+			results[i] = check_signature(key, sigs[i]);
+		if (rv == VB2_SUCCESS)
+			rv = results[i];
+	}
+
+	return rv;
+}
+
 test_mockable
 vb2_error_t vb2_verify_data(const uint8_t *data, uint32_t size,
 			    struct vb2_signature *sig,
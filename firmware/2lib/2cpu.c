@@ -0,0 +1,117 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * CPU feature probing for the accelerated implementations picked at runtime.
+ */
+
+#include "2cpu.h"
+#include "2sysincludes.h"
+
+#if defined(__aarch64__) && defined(CHROMEOS_ENVIRONMENT)
+#include <sys/auxv.h>
+
+#ifndef HWCAP_SHA1
+#define HWCAP_SHA1 (1 << 5)
+#endif
+#ifndef HWCAP_CRC32
+#define HWCAP_CRC32 (1 << 7)
+#endif
+#ifndef HWCAP_SHA512
+#define HWCAP_SHA512 (1 << 21)
+#endif
+#endif
+
+#if defined(__i386__) || defined(__x86_64__)
+static void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t *eax,
+		  uint32_t *ebx, uint32_t *ecx, uint32_t *edx)
+{
+	asm volatile ("cpuid"
+		      : "=a"(*eax), "=b"(*ebx), "=c"(*ecx), "=d"(*edx)
+		      : "a"(leaf), "c"(subleaf));
+}
+
+static uint64_t xgetbv(uint32_t index)
+{
+	uint32_t eax, edx;
+
+	asm volatile ("xgetbv" : "=a"(eax), "=d"(edx) : "c"(index));
+	return ((uint64_t)edx << 32) | eax;
+}
+
+static uint32_t probe_features(void)
+{
+	uint32_t features = 0;
+	uint32_t max_leaf, eax, ebx, ecx, edx;
+
+	cpuid(0, 0, &max_leaf, &ebx, &ecx, &edx);
+
+	cpuid(1, 0, &eax, &ebx, &ecx, &edx);
+	/* PCLMULQDQ (bit 1) only uses XMM registers, which every OS saves */
+	if (ecx & (1 << 1))
+		features |= VB2_CPU_X86_PCLMUL;
+
+	/*
+	 * Besides the CPU supporting AVX2, whoever owns XCR0 (the OS, or
+	 * firmware running on bare metal) must have enabled saving YMM state.
+	 * That needs AVX (bit 28) and OSXSAVE (bit 27), then XMM (bit 1) and
+	 * YMM (bit 2) state enabled in XCR0.
+	 */
+	if (max_leaf >= 7 && (ecx & (3 << 27)) == (3 << 27) &&
+	    (xgetbv(0) & 0x6) == 0x6) {
+		/* AVX2 (bit 5) */
+		cpuid(7, 0, &eax, &ebx, &ecx, &edx);
+		if (ebx & (1 << 5))
+			features |= VB2_CPU_X86_AVX2;
+	}
+
+	return features;
+}
+#elif defined(__aarch64__)
+static uint32_t probe_features(void)
+{
+	uint32_t features = 0;
+#ifdef CHROMEOS_ENVIRONMENT
+	/* Userspace can't read the ID registers without the kernel's help */
+	unsigned long hwcap = getauxval(AT_HWCAP);
+
+	if (hwcap & HWCAP_SHA1)
+		features |= VB2_CPU_ARM_SHA1;
+	if (hwcap & HWCAP_SHA512)
+		features |= VB2_CPU_ARM_SHA512;
+	if (hwcap & HWCAP_CRC32)
+		features |= VB2_CPU_ARM_CRC32;
+#else
+	uint64_t isar0;
+
+	asm ("mrs %0, id_aa64isar0_el1" : "=r"(isar0));
+	/* SHA1, bits [11:8]: 1 if SHA1 instructions are implemented */
+	if (((isar0 >> 8) & 0xf) >= 1)
+		features |= VB2_CPU_ARM_SHA1;
+	/* SHA2, bits [15:12]: 2 if SHA512 instructions are implemented too */
+	if (((isar0 >> 12) & 0xf) >= 2)
+		features |= VB2_CPU_ARM_SHA512;
+	/* CRC32, bits [19:16]: 1 if CRC32 instructions are implemented */
+	if (((isar0 >> 16) & 0xf) >= 1)
+		features |= VB2_CPU_ARM_CRC32;
+#endif
+	return features;
+}
+#else
+static uint32_t probe_features(void)
+{
+	return 0;
+}
+#endif
+
+bool vb2_cpu_has(uint32_t features)
+{
+	/* -1 until the CPU has been probed.  Probing is idempotent, so racing
+	   callers at worst both probe. */
+	static int64_t cached = -1;
+
+	if (cached < 0)
+		cached = probe_features();
+
+	return ((uint32_t)cached & features) == features;
+}
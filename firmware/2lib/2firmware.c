@@ -27,6 +27,7 @@ vb2_error_t vb2_load_fw_keyblock(struct vb2_context *ctx)
 	struct vb2_keyblock *kb;
 	uint32_t block_size;
 
+	uint32_t start_ms;
 	vb2_error_t rv = VB2_SUCCESS;
 
 	vb2_workbuf_from_ctx(ctx, &wb);
@@ -37,8 +38,11 @@ vb2_error_t vb2_load_fw_keyblock(struct vb2_context *ctx)
 	if (!key_data)
 		return VB2_ERROR_FW_KEYBLOCK_WORKBUF_ROOT_KEY;
 
-	VB2_TRY(vb2ex_read_resource(ctx, VB2_RES_GBB, gbb->rootkey_offset,
-				    key_data, key_size));
+	start_ms = vb2ex_mtime();
+	rv = vb2ex_read_resource(ctx, VB2_RES_GBB, gbb->rootkey_offset,
+				 key_data, key_size);
+	vb2_timing_end(ctx, VB2_TIMING_GBB_READ, start_ms, rv ? 0 : key_size);
+	VB2_TRY(rv);
 
 	/* Unpack the root key */
 	VB2_TRY(vb2_unpack_key_buffer(&root_key, key_data, key_size));
@@ -68,8 +72,10 @@ vb2_error_t vb2_load_fw_keyblock(struct vb2_context *ctx)
 	VB2_TRY(vb2ex_read_resource(ctx, VB2_RES_FW_VBLOCK, 0, kb, block_size));
 
 	/* Verify the keyblock */
-	VB2_TRY(vb2_verify_keyblock(kb, block_size, &root_key, &wb),
-		ctx, VB2_RECOVERY_FW_KEYBLOCK);
+	start_ms = vb2ex_mtime();
+	rv = vb2_verify_keyblock(kb, block_size, &root_key, &wb);
+	vb2_timing_end(ctx, VB2_TIMING_KEYBLOCK_VERIFY, start_ms, block_size);
+	VB2_TRY(rv, ctx, VB2_RECOVERY_FW_KEYBLOCK);
 
 	/* Key version is the upper 16 bits of the composite firmware version */
 	if (kb->data_key.key_version > VB2_MAX_KEY_VERSION)
@@ -139,6 +145,7 @@ vb2_error_t vb2_load_fw_preamble(struct vb2_context *ctx)
 	struct vb2_fw_preamble *pre;
 	uint32_t pre_size;
 
+	uint32_t start_ms;
 	vb2_error_t rv = VB2_SUCCESS;
 
 	vb2_workbuf_from_ctx(ctx, &wb);
@@ -174,8 +181,10 @@ vb2_error_t vb2_load_fw_preamble(struct vb2_context *ctx)
 	/* Work buffer now contains the data subkey data and the preamble */
 
 	/* Verify the preamble */
-	VB2_TRY(vb2_verify_fw_preamble(pre, pre_size, &data_key, &wb),
-		ctx, VB2_RECOVERY_FW_PREAMBLE);
+	start_ms = vb2ex_mtime();
+	rv = vb2_verify_fw_preamble(pre, pre_size, &data_key, &wb);
+	vb2_timing_end(ctx, VB2_TIMING_PREAMBLE_VERIFY, start_ms, pre_size);
+	VB2_TRY(rv, ctx, VB2_RECOVERY_FW_PREAMBLE);
 
 	/*
 	 * Firmware version is the lower 16 bits of the composite firmware
@@ -56,8 +56,11 @@ vb2_error_t vb2_gbb_read_root_key(struct vb2_context *ctx,
 {
 	struct vb2_gbb_header *gbb = vb2_get_gbb(ctx);
 	uint32_t size_in = gbb->rootkey_size;
+	uint32_t start_ms = vb2ex_mtime();
 	vb2_error_t ret = vb2_gbb_read_key(ctx, gbb->rootkey_offset,
 					   &size_in, keyp, wb);
+	vb2_timing_end(ctx, VB2_TIMING_GBB_READ, start_ms,
+		       ret ? 0 : size_in);
 	if (size)
 		*size = size_in;
 	return ret;
@@ -70,8 +73,11 @@ vb2_error_t vb2_gbb_read_recovery_key(struct vb2_context *ctx,
 {
 	struct vb2_gbb_header *gbb = vb2_get_gbb(ctx);
 	uint32_t size_in = gbb->recovery_key_size;
+	uint32_t start_ms = vb2ex_mtime();
 	vb2_error_t ret = vb2_gbb_read_key(ctx, gbb->recovery_key_offset,
 					   &size_in, keyp, wb);
+	vb2_timing_end(ctx, VB2_TIMING_GBB_READ, start_ms,
+		       ret ? 0 : size_in);
 	if (size)
 		*size = size_in;
 	return ret;
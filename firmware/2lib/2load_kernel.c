@@ -28,6 +28,9 @@ enum vb2_load_partition_flags {
 };
 
 #define KBUF_SIZE 65536  /* Bytes to read at start of kernel partition */
+#define KBODY_CHUNK_SIZE (256 * 1024)  /* Bytes of body to read per hash step */
+#define MINIOS_REGION_SIZE (256 * 1024 * 1024)  /* Bytes searched at each end */
+#define MINIOS_BATCH_SIZE (1024 * 1024)  /* Bytes read per MiniOS search step */
 
 /**
  * Return a pointer to the keyblock inside a vblock.
@@ -143,6 +146,7 @@ static vb2_error_t vb2_verify_kernel_vblock(struct vb2_context *ctx,
 	bool need_keyblock_valid = vb2_need_kernel_verification(ctx);
 	int keyblock_valid = 1;  /* Assume valid */
 
+	uint32_t start_ms;
 	vb2_error_t rv;
 
 	/* Locate key to verify kernel.  This will either be a recovery key, or
@@ -162,7 +166,10 @@ static vb2_error_t vb2_verify_kernel_vblock(struct vb2_context *ctx,
 
 	/* Verify the keyblock. */
 	struct vb2_keyblock *keyblock = get_keyblock(kbuf);
+	start_ms = vb2ex_mtime();
 	rv = vb2_verify_keyblock(keyblock, kbuf_size, &kernel_key, wb);
+	vb2_timing_end(ctx, VB2_TIMING_KEYBLOCK_VERIFY, start_ms,
+		       rv ? 0 : keyblock->keyblock_size);
 	if (rv) {
 		VB2_DEBUG("Verifying keyblock signature failed.\n");
 		keyblock_valid = 0;
@@ -264,10 +271,13 @@ static vb2_error_t vb2_verify_kernel_vblock(struct vb2_context *ctx,
 
 	/* Verify the preamble, which follows the keyblock */
 	struct vb2_kernel_preamble *preamble = get_preamble(kbuf);
+	start_ms = vb2ex_mtime();
 	rv = vb2_verify_kernel_preamble(preamble,
 					kbuf_size - keyblock->keyblock_size,
 					&data_key,
 					wb);
+	vb2_timing_end(ctx, VB2_TIMING_PREAMBLE_VERIFY, start_ms,
+		       rv ? 0 : preamble->preamble_size);
 	if (rv) {
 		VB2_DEBUG("Preamble verification failed.\n");
 		return rv;
@@ -327,6 +337,110 @@ static vb2_error_t vb2_verify_kernel_vblock(struct vb2_context *ctx,
 	return VB2_SUCCESS;
 }
 
+/**
+ * Read a kernel body from the stream, extending a digest with each chunk.
+ *
+ * If the stream supports asynchronous reads, the read of the next chunk is
+ * kept in flight while the current one is hashed, so disk and CPU time
+ * overlap.  Otherwise each chunk is read synchronously and then hashed while
+ * it is still in cache.
+ *
+ * @param stream		Stream to read from
+ * @param dc			Digest context to extend
+ * @param buf			Destination buffer
+ * @param size			Number of bytes to read
+ * @param read_ms		Incremented by time spent waiting on the disk
+ * @param hash_ms		Incremented by time spent hashing
+ * @return VB2_SUCCESS, or non-zero error code.
+ */
+static vb2_error_t read_and_hash_body(VbExStream_t stream,
+				      struct vb2_digest_context *dc,
+				      uint8_t *buf, uint32_t size,
+				      uint32_t *read_ms, uint32_t *hash_ms)
+{
+	uint32_t submitted, done, chunk;
+	uint32_t pending = 0;
+	uint32_t start_ts;
+	vb2_error_t rv;
+
+	if (!size)
+		return VB2_SUCCESS;
+
+	start_ts = vb2ex_mtime();
+	submitted = VB2_MIN(size, KBODY_CHUNK_SIZE);
+	rv = VbExStreamReadAsync(stream, submitted, buf);
+	*read_ms += vb2ex_mtime() - start_ts;
+
+	if (rv == VB2_ERROR_EX_UNIMPLEMENTED) {
+		for (done = 0; done < size; done += chunk) {
+			chunk = VB2_MIN(size - done, KBODY_CHUNK_SIZE);
+
+			start_ts = vb2ex_mtime();
+			if (VbExStreamRead(stream, chunk, buf + done)) {
+				VB2_DEBUG("Unable to read kernel data.\n");
+				return VB2_ERROR_LOAD_PARTITION_READ_BODY;
+			}
+			*read_ms += vb2ex_mtime() - start_ts;
+
+			start_ts = vb2ex_mtime();
+			if (vb2_digest_extend(dc, buf + done, chunk)) {
+				VB2_DEBUG("Unable to hash kernel data.\n");
+				return VB2_ERROR_LOAD_PARTITION_VERIFY_BODY;
+			}
+			*hash_ms += vb2ex_mtime() - start_ts;
+		}
+		return VB2_SUCCESS;
+	}
+
+	if (rv) {
+		VB2_DEBUG("Unable to start reading kernel data.\n");
+		return VB2_ERROR_LOAD_PARTITION_READ_BODY;
+	}
+	pending++;
+
+	for (done = 0; done < size; done += chunk) {
+		chunk = VB2_MIN(size - done, KBODY_CHUNK_SIZE);
+
+		start_ts = vb2ex_mtime();
+		/* Queue the next chunk before waiting for this one. */
+		if (submitted < size) {
+			uint32_t next = VB2_MIN(size - submitted,
+						KBODY_CHUNK_SIZE);
+			if (VbExStreamReadAsync(stream, next,
+						buf + submitted)) {
+				VB2_DEBUG("Unable to queue kernel data read.\n");
+				rv = VB2_ERROR_LOAD_PARTITION_READ_BODY;
+				goto drain;
+			}
+			submitted += next;
+			pending++;
+		}
+		pending--;
+		if (VbExStreamWaitAsync(stream)) {
+			VB2_DEBUG("Unable to read kernel data.\n");
+			rv = VB2_ERROR_LOAD_PARTITION_READ_BODY;
+			goto drain;
+		}
+		*read_ms += vb2ex_mtime() - start_ts;
+
+		start_ts = vb2ex_mtime();
+		if (vb2_digest_extend(dc, buf + done, chunk)) {
+			VB2_DEBUG("Unable to hash kernel data.\n");
+			rv = VB2_ERROR_LOAD_PARTITION_VERIFY_BODY;
+			goto drain;
+		}
+		*hash_ms += vb2ex_mtime() - start_ts;
+	}
+
+	return VB2_SUCCESS;
+
+drain:
+	/* The caller may reuse buf, so don't leave reads landing in it. */
+	while (pending--)
+		VbExStreamWaitAsync(stream);
+	return rv;
+}
+
 /**
  * Load and verify a ChromeOS kernel partition from the stream.
  *
@@ -335,15 +449,18 @@ static vb2_error_t vb2_verify_kernel_vblock(struct vb2_context *ctx,
  * @param stream		Stream to load kernel from
  * @param lpflags		Flags (one or more of vb2_load_partition_flags)
  * @param kernel_version	The kernel version of this partition.
+ * @param bytes_read		Set to the number of bytes read from the stream
  * @return VB2_SUCCESS, or non-zero error code.
  */
 static vb2_error_t vb2_load_chromeos_kernel(
 	struct vb2_context *ctx, struct vb2_kernel_params *params,
-	VbExStream_t stream, uint32_t lpflags, uint32_t *kernel_version)
+	VbExStream_t stream, uint32_t lpflags, uint32_t *kernel_version,
+	uint32_t *bytes_read)
 {
 	uint32_t read_ms = 0, start_ts;
 	struct vb2_workbuf wb;
 
+	*bytes_read = 0;
 	vb2_workbuf_from_ctx(ctx, &wb);
 
 	/* Allocate kernel header buffer in workbuf */
@@ -357,6 +474,7 @@ static vb2_error_t vb2_load_chromeos_kernel(
 		return VB2_ERROR_LOAD_PARTITION_READ_VBLOCK;
 	}
 	read_ms += vb2ex_mtime() - start_ts;
+	*bytes_read = KBUF_SIZE;
 
 	if (vb2_verify_kernel_vblock(ctx, kbuf, KBUF_SIZE, lpflags, &wb,
 				     kernel_version))
@@ -392,7 +510,30 @@ static vb2_error_t vb2_load_chromeos_kernel(
 		return 	VB2_ERROR_LOAD_PARTITION_BODY_SIZE;
 	}
 
-	uint32_t body_toread = preamble->body_signature.data_size;
+	/* Get key for body verification from the keyblock. */
+	struct vb2_public_key data_key;
+	if (vb2_unpack_key(&data_key, &keyblock->data_key)) {
+		VB2_DEBUG("Unable to unpack kernel data key\n");
+		return VB2_ERROR_LOAD_PARTITION_DATA_KEY;
+	}
+
+	data_key.allow_hwcrypto = vb2api_hwcrypto_allowed(ctx);
+
+	/*
+	 * Hash the body as it is read, so each chunk is digested while it is
+	 * still in cache instead of in a second pass over the whole buffer.
+	 */
+	struct vb2_digest_context dc;
+	uint32_t body_size = preamble->body_signature.data_size;
+	uint32_t hash_ms = 0;
+
+	if (vb2_digest_init(&dc, data_key.allow_hwcrypto, data_key.hash_alg,
+			    body_size)) {
+		VB2_DEBUG("Unable to start kernel data hash.\n");
+		return VB2_ERROR_LOAD_PARTITION_VERIFY_BODY;
+	}
+
+	uint32_t body_toread = body_size;
 	uint8_t *body_readptr = kernbuf;
 
 	/*
@@ -404,34 +545,47 @@ static vb2_error_t vb2_load_chromeos_kernel(
 		body_copied = body_toread;  /* Don't over-copy tiny kernel */
 	memcpy(body_readptr, kbuf + body_offset, body_copied);
 	body_toread -= body_copied;
-	body_readptr += body_copied;
 
-	/* Read the kernel data */
-	start_ts = vb2ex_mtime();
-	if (body_toread && VbExStreamRead(stream, body_toread, body_readptr)) {
-		VB2_DEBUG("Unable to read kernel data.\n");
-		return VB2_ERROR_LOAD_PARTITION_READ_BODY;
+	uint32_t body_start_ms = vb2ex_mtime();
+	start_ts = body_start_ms;
+	if (vb2_digest_extend(&dc, body_readptr, body_copied)) {
+		VB2_DEBUG("Unable to hash kernel data.\n");
+		return VB2_ERROR_LOAD_PARTITION_VERIFY_BODY;
 	}
-	read_ms += vb2ex_mtime() - start_ts;
+	hash_ms += vb2ex_mtime() - start_ts;
+	body_readptr += body_copied;
+
+	/* Read the rest of the kernel data, hashing each chunk as it lands */
+	vb2_error_t rv = read_and_hash_body(stream, &dc, body_readptr,
+					    body_toread, &read_ms, &hash_ms);
+	if (rv)
+		return rv;
+
+	uint32_t body_read = body_size - body_copied;
+	*bytes_read += body_read;
+	vb2_timing_add(ctx, VB2_TIMING_BODY_HASH, body_start_ms, hash_ms,
+		       body_size);
 	if (read_ms == 0)  /* Avoid division by 0 in speed calculation */
 		read_ms = 1;
-	VB2_DEBUG("read %u KB in %u ms at %u KB/s.\n",
-		  (body_toread + KBUF_SIZE) / 1024, read_ms,
-		  (uint32_t)(((body_toread + KBUF_SIZE) * VB2_MSEC_PER_SEC) /
-			     (read_ms * 1024)));
+	VB2_DEBUG("read %u KB in %u ms at %u KB/s, hashed in %u ms.\n",
+		  (body_read + KBUF_SIZE) / 1024, read_ms,
+		  (uint32_t)(((body_read + KBUF_SIZE) * VB2_MSEC_PER_SEC) /
+			     (read_ms * 1024)), hash_ms);
 
-	/* Get key for preamble/data verification from the keyblock. */
-	struct vb2_public_key data_key;
-	if (vb2_unpack_key(&data_key, &keyblock->data_key)) {
-		VB2_DEBUG("Unable to unpack kernel data key\n");
-		return VB2_ERROR_LOAD_PARTITION_DATA_KEY;
+	/* Verify kernel data signature against the streamed digest */
+	struct vb2_hash hash;
+	if (vb2_digest_finalize(&dc, hash.raw,
+				vb2_digest_size(data_key.hash_alg))) {
+		VB2_DEBUG("Unable to finalize kernel data hash.\n");
+		return VB2_ERROR_LOAD_PARTITION_VERIFY_BODY;
 	}
 
-	data_key.allow_hwcrypto = vb2api_hwcrypto_allowed(ctx);
-
-	/* Verify kernel data */
-	if (vb2_verify_data(kernbuf, kernbuf_size, &preamble->body_signature,
-			    &data_key, &wb)) {
+	start_ts = vb2ex_mtime();
+	rv = vb2_verify_digest(&data_key, &preamble->body_signature, hash.raw,
+			       &wb);
+	vb2_timing_end(ctx, VB2_TIMING_RSA, start_ts,
+		       preamble->body_signature.sig_size);
+	if (rv) {
 		VB2_DEBUG("Kernel data verification failed.\n");
 		return VB2_ERROR_LOAD_PARTITION_VERIFY_BODY;
 	}
@@ -461,20 +615,26 @@ static vb2_error_t try_minios_kernel(struct vb2_context *ctx,
 	uint64_t sectors_left = disk_info->lba_count - sector;
 	const uint32_t lpflags = VB2_LOAD_PARTITION_FLAG_MINIOS;
 	uint32_t kernel_version = 0;
+	uint32_t bytes_read;
+	uint32_t start_ms = vb2ex_mtime();
 	vb2_error_t rv = VB2_ERROR_LK_NO_KERNEL_FOUND;
 
 	/* Re-open stream at correct offset to pass to vb2_load_partition. */
 	if (VbExStreamOpen(disk_info->handle, sector, sectors_left,
 			   &stream)) {
 		VB2_DEBUG("Unable to open disk handle.\n");
+		vb2_timing_kernel_try(ctx, 0, start_ms, 0,
+				      VB2_ERROR_LOAD_PARTITION_READ_VBLOCK);
 		return rv;
 	}
 
 	/* We are looking for ChromeOS partitions */
-	rv = vb2_load_chromeos_kernel(ctx, params, stream, lpflags, &kernel_version);
+	rv = vb2_load_chromeos_kernel(ctx, params, stream, lpflags,
+				      &kernel_version, &bytes_read);
 	VB2_DEBUG("vb2_load_chromeos_kernel returned: %#x\n", rv);
 
 	VbExStreamClose(stream);
+	vb2_timing_kernel_try(ctx, 0, start_ms, bytes_read, rv);
 
 	if (rv)
 		return VB2_ERROR_LK_NO_KERNEL_FOUND;
@@ -484,89 +644,210 @@ static vb2_error_t try_minios_kernel(struct vb2_context *ctx,
 	return rv;
 }
 
-static vb2_error_t try_minios_sectors(struct vb2_context *ctx,
-				      struct vb2_kernel_params *params,
-				      struct vb2_disk_info *disk_info,
-				      uint64_t start, uint64_t count)
+/* State for reading a range of sectors in batches, double-buffered */
+struct minios_scan {
+	struct vb2_disk_info *disk_info;
+	VbExStream_t stream;	/* NULL if not open */
+	uint8_t *buf[2];	/* Alternating batch buffers */
+	int pending[2];		/* Asynchronous read into buf[i] in flight */
+	uint64_t batch_count;	/* Sectors per batch */
+	uint64_t sector;	/* First sector of the current batch */
+	uint64_t submitted;	/* Sectors before this have been submitted */
+	uint64_t end;		/* End of the range */
+	uint32_t cur;		/* Index of the buffer for the current batch */
+	int async;		/* Stream supports asynchronous reads */
+};
+
+/* Sectors read per step of the MiniOS search */
+static uint64_t minios_batch_count(const struct vb2_disk_info *disk_info)
 {
-	const uint32_t buf_size = count * disk_info->bytes_per_lba;
-	char *buf;
-	VbExStream_t stream;
-	uint64_t isector;
-	vb2_error_t rv = VB2_ERROR_LK_NO_KERNEL_FOUND;
+	return VB2_MIN((disk_info->lba_count + 1) / 2,
+		       MINIOS_BATCH_SIZE / disk_info->bytes_per_lba);
+}
 
-	buf = malloc(buf_size);
-	if (buf == NULL) {
-		VB2_DEBUG("Unable to allocate disk read buffer.\n");
-		return rv;
-	}
+/* Close the stream, dropping any batch read ahead. */
+static void minios_scan_close(struct minios_scan *scan)
+{
+	if (scan->stream)
+		VbExStreamClose(scan->stream);
+	scan->stream = NULL;
+	scan->pending[0] = scan->pending[1] = 0;
+	scan->submitted = 0;
+}
 
-	if (VbExStreamOpen(disk_info->handle, start, count, &stream)) {
-		VB2_DEBUG("Unable to open disk handle.\n");
-		free(buf);
-		return rv;
+/* Submit an asynchronous read of the batch at scan->submitted. */
+static vb2_error_t minios_scan_submit(struct minios_scan *scan, uint32_t i)
+{
+	const uint64_t count = VB2_MIN(scan->batch_count,
+				       scan->end - scan->submitted);
+	vb2_error_t rv;
+
+	rv = VbExStreamReadAsync(scan->stream,
+				 count * scan->disk_info->bytes_per_lba,
+				 scan->buf[i]);
+	if (rv == VB2_ERROR_EX_UNIMPLEMENTED && !scan->pending[!i]) {
+		scan->async = 0;
+		return VB2_SUCCESS;
 	}
-	if (VbExStreamRead(stream, buf_size, buf)) {
-		VB2_DEBUG("Unable to read disk.\n");
-		free(buf);
-		VbExStreamClose(stream);
+	if (rv)
 		return rv;
+
+	scan->pending[i] = 1;
+	scan->submitted += count;
+	return VB2_SUCCESS;
+}
+
+/*
+ * Wait for any read still in flight and close the stream, so the disk can be
+ * used for something else.  The batch read ahead stays valid, and reading
+ * resumes after it.
+ */
+static void minios_scan_pause(struct minios_scan *scan)
+{
+	const uint32_t next = !scan->cur;
+
+	if (!scan->stream)
+		return;
+
+	if (scan->pending[next]) {
+		scan->pending[next] = 0;
+		if (VbExStreamWaitAsync(scan->stream)) {
+			/* The next batch will be read again. */
+			minios_scan_close(scan);
+			return;
+		}
 	}
-	VbExStreamClose(stream);
+
+	VbExStreamClose(scan->stream);
+	scan->stream = NULL;
+}
+
+/* Return the index of the first sector in buf starting with the magic. */
+static uint64_t minios_find_magic(const uint8_t *buf, uint64_t count,
+				  uint32_t bytes_per_lba)
+{
+	uint64_t isector;
 
 	for (isector = 0; isector < count; isector++) {
-		if (memcmp(buf + isector * disk_info->bytes_per_lba,
-			   VB2_KEYBLOCK_MAGIC, VB2_KEYBLOCK_MAGIC_SIZE))
-			continue;
-		VB2_DEBUG("Match on sector %" PRIu64 " / %" PRIu64 "\n",
-			  start + isector,
-			  disk_info->lba_count - 1);
-		rv = try_minios_kernel(ctx, params, disk_info, start + isector);
-		if (rv == VB2_SUCCESS)
+		if (!memcmp(buf + isector * bytes_per_lba,
+			    VB2_KEYBLOCK_MAGIC, VB2_KEYBLOCK_MAGIC_SIZE))
 			break;
 	}
 
-	free(buf);
-	return rv;
+	return isector;
+}
+
+/*
+ * Read the batch at scan->sector into scan->buf[scan->cur], queueing the read
+ * of the following batch first when the stream supports it.
+ */
+static vb2_error_t minios_scan_read(struct minios_scan *scan, uint64_t count)
+{
+	const uint32_t cur = scan->cur;
+	const uint64_t bytes_per_lba = scan->disk_info->bytes_per_lba;
+
+	if (!scan->stream) {
+		/* Keep the batch read ahead before a pause, if any. */
+		if (scan->submitted < scan->sector)
+			scan->submitted = scan->sector;
+		if (VbExStreamOpen(scan->disk_info->handle, scan->submitted,
+				   scan->end - scan->submitted,
+				   &scan->stream)) {
+			scan->stream = NULL;
+			scan->submitted = 0;
+			return VB2_ERROR_UNKNOWN;
+		}
+	}
+
+	/* The current batch is only unsubmitted after (re)opening. */
+	if (scan->async && scan->submitted == scan->sector)
+		VB2_TRY(minios_scan_submit(scan, cur));
+
+	if (scan->async && scan->submitted < scan->end)
+		VB2_TRY(minios_scan_submit(scan, !cur));
+
+	if (!scan->async)
+		return VbExStreamRead(scan->stream, count * bytes_per_lba,
+				      scan->buf[cur]);
+
+	if (scan->pending[cur]) {
+		/* Reads complete in order, and this one is the oldest. */
+		scan->pending[cur] = 0;
+		return VbExStreamWaitAsync(scan->stream);
+	}
+
+	return VB2_SUCCESS;
 }
 
 static vb2_error_t try_minios_sector_region(struct vb2_context *ctx,
 					    struct vb2_kernel_params *params,
 					    struct vb2_disk_info *disk_info,
-					    int end_region)
+					    uint8_t *buf, int end_region)
 {
 	const uint64_t disk_count_half = (disk_info->lba_count + 1) / 2;
-	const uint64_t check_count_256 = 256 * 1024
-		* 1024 / disk_info->bytes_per_lba;  // 256 MB
-	const uint64_t batch_count_1 = 1024
-		* 1024 / disk_info->bytes_per_lba;  // 1 MB
+	const uint64_t check_count_256 = MINIOS_REGION_SIZE /
+		disk_info->bytes_per_lba;
 	const uint64_t check_count = VB2_MIN(disk_count_half, check_count_256);
-	const uint64_t batch_count = VB2_MIN(disk_count_half, batch_count_1);
-	uint64_t sector;
-	uint64_t start;
-	uint64_t end;
+	struct minios_scan scan = {
+		.disk_info = disk_info,
+		.batch_count = minios_batch_count(disk_info),
+		.async = 1,
+	};
 	const char *region_name;
-	vb2_error_t rv = VB2_ERROR_LK_NO_KERNEL_FOUND;
+	vb2_error_t rv;
+
+	scan.buf[0] = buf;
+	scan.buf[1] = buf + scan.batch_count * disk_info->bytes_per_lba;
 
 	if (!end_region) {
-		start = 0;
-		end = check_count;
+		scan.sector = 0;
+		scan.end = check_count;
 		region_name = "start";
 	} else {
-		start = disk_info->lba_count - check_count;
-		end = disk_info->lba_count;
+		scan.sector = disk_info->lba_count - check_count;
+		scan.end = disk_info->lba_count;
 		region_name = "end";
 	}
 
 	VB2_DEBUG("Checking %s of disk for kernels...\n", region_name);
-	for (sector = start; sector < end; sector += batch_count) {
-		rv = try_minios_sectors(ctx, params, disk_info, sector,
-					batch_count);
-		if (rv == VB2_SUCCESS)
-			return rv;
+	for (; scan.sector < scan.end; scan.sector += scan.batch_count) {
+		const uint64_t count = VB2_MIN(scan.batch_count,
+					       scan.end - scan.sector);
+		uint64_t isector;
+
+		if (minios_scan_read(&scan, count)) {
+			/* Skip this batch, and start over after it. */
+			VB2_DEBUG("Unable to read disk.\n");
+			minios_scan_close(&scan);
+			continue;
+		}
+
+		for (isector = 0; ; isector++) {
+			isector += minios_find_magic(
+				scan.buf[scan.cur] +
+				isector * disk_info->bytes_per_lba,
+				count - isector, disk_info->bytes_per_lba);
+			if (isector >= count)
+				break;
+
+			VB2_DEBUG("Match on sector %" PRIu64 " / %" PRIu64 "\n",
+				  scan.sector + isector,
+				  disk_info->lba_count - 1);
+			/* The kernel is read through a stream of its own. */
+			minios_scan_pause(&scan);
+			rv = try_minios_kernel(ctx, params, disk_info,
+					       scan.sector + isector);
+			if (rv == VB2_SUCCESS) {
+				minios_scan_close(&scan);
+				return rv;
+			}
+		}
+
+		scan.cur = !scan.cur;
 	}
 
-	return rv;
+	minios_scan_close(&scan);
+	return VB2_ERROR_LK_NO_KERNEL_FOUND;
 }
 
 /*
@@ -581,23 +862,44 @@ vb2_error_t vb2api_load_minios_kernel(struct vb2_context *ctx,
 {
 	vb2_error_t rv;
 	int end_region_first = vb2_nv_get(ctx, VB2_NV_MINIOS_PRIORITY);
+	/* One pair of batch buffers serves both regions. */
+	uint8_t *buf = malloc(2 * minios_batch_count(disk_info) *
+			      disk_info->bytes_per_lba);
+
+	if (!buf) {
+		VB2_DEBUG("Unable to allocate disk read buffer.\n");
+		return VB2_ERROR_LK_NO_KERNEL_FOUND;
+	}
 
 	if (minios_flags & VB2_MINIOS_FLAG_NON_ACTIVE)
 		rv = VB2_ERROR_UNKNOWN;  /* Ignore active partition */
 	else
-		rv = try_minios_sector_region(ctx, params, disk_info,
+		rv = try_minios_sector_region(ctx, params, disk_info, buf,
 					      end_region_first);
 
 	if (rv)
-		rv = try_minios_sector_region(ctx, params, disk_info,
+		rv = try_minios_sector_region(ctx, params, disk_info, buf,
 					      !end_region_first);
 
+	free(buf);
+
 	if (rv == VB2_SUCCESS)
 		params->disk_handle = disk_info->handle;
 
 	return rv;
 }
 
+/* Return the size of the primary and secondary GPT headers and entries */
+static uint32_t gpt_size(GptData *gpt)
+{
+	GptHeader *header = (GptHeader *)gpt->primary_header;
+	uint64_t entries_bytes = (uint64_t)header->number_of_entries *
+				 header->size_of_entry;
+
+	return 2 * (gpt->sector_bytes +
+		    VB2_MIN(entries_bytes, GPT_ENTRIES_ALLOC_SIZE));
+}
+
 static void update_kernel_version(struct vb2_context *ctx)
 {
 	struct vb2_shared_data *sd = vb2_get_sd(ctx);
@@ -652,6 +954,8 @@ vb2_error_t vb2api_load_kernel(struct vb2_context *ctx,
 	struct vb2_shared_data *sd = vb2_get_sd(ctx);
 	int found_partitions = 0;
 	uint32_t kernel_version;
+	uint32_t bytes_read;
+	uint32_t start_ms;
 	vb2_error_t rv = VB2_ERROR_LK_NO_KERNEL_FOUND;
 
 	/* Read GPT data */
@@ -662,23 +966,30 @@ vb2_error_t vb2api_load_kernel(struct vb2_context *ctx,
 	gpt.gpt_drive_sectors = disk_info->lba_count;
 	gpt.flags = disk_info->flags & VB2_DISK_FLAG_EXTERNAL_GPT
 			? GPT_FLAG_EXTERNAL : 0;
+	start_ms = vb2ex_mtime();
 	if (AllocAndReadGptData(disk_info->handle, &gpt)) {
 		VB2_DEBUG("Unable to read GPT data\n");
+		vb2_timing_end(ctx, VB2_TIMING_GPT_LOAD, start_ms, 0);
 		goto exit;
 	}
 
 	/* Initialize GPT library */
 	if (GptInit(&gpt)) {
 		VB2_DEBUG("Error parsing GPT\n");
+		vb2_timing_end(ctx, VB2_TIMING_GPT_LOAD, start_ms, 0);
 		goto exit;
 	}
+	vb2_timing_end(ctx, VB2_TIMING_GPT_LOAD, start_ms, gpt_size(&gpt));
 
 	/* Loop over candidate kernel partitions */
 	GptEntry *entry;
 	while ((entry = GptNextKernelEntry(&gpt))) {
 		uint64_t part_start = entry->starting_lba;
 		uint64_t part_size = GptGetEntrySizeLba(entry);
+		uint32_t partition = gpt.current_kernel + 1;
 		kernel_version = 0;
+		bytes_read = 0;
+		start_ms = vb2ex_mtime();
 
 		VB2_DEBUG("Found %s kernel entry at %"
 			  PRIu64 " size %" PRIu64 "\n",
@@ -702,17 +1013,24 @@ vb2_error_t vb2api_load_kernel(struct vb2_context *ctx,
 			if (VbExStreamOpen(disk_info->handle, part_start, part_size, &stream)) {
 				VB2_DEBUG("Partition error getting stream.\n");
 				VB2_DEBUG("Marking kernel as invalid.\n");
+				vb2_timing_kernel_try(
+					ctx, partition, start_ms, 0,
+					VB2_ERROR_LOAD_PARTITION_READ_VBLOCK);
 				GptUpdateKernelEntry(&gpt, GPT_UPDATE_ENTRY_BAD);
 				continue;
 			}
 
 			/* Append status and try to load chromeos partition */
-			rv = vb2_load_chromeos_kernel(ctx, params, stream, 0, &kernel_version);
+			rv = vb2_load_chromeos_kernel(ctx, params, stream, 0,
+						      &kernel_version,
+						      &bytes_read);
 			VbExStreamClose(stream);
 		} else {
 			rv = VB2_ERROR_LK_INVALID_KERNEL_FOUND;
 		}
 
+		vb2_timing_kernel_try(ctx, partition, start_ms, bytes_read, rv);
+
 		if (rv == VB2_SUCCESS)
 			break;
 
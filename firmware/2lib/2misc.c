@@ -214,6 +214,9 @@ vb2_error_t vb2_fw_init_gbb(struct vb2_context *ctx)
 	struct vb2_gbb_header *gbb;
 	struct vb2_workbuf wb;
 
+	uint32_t start_ms;
+	vb2_error_t rv;
+
 	vb2_workbuf_from_ctx(ctx, &wb);
 
 	/* Read GBB into next chunk of work buffer */
@@ -221,7 +224,11 @@ vb2_error_t vb2_fw_init_gbb(struct vb2_context *ctx)
 	if (!gbb)
 		return VB2_ERROR_GBB_WORKBUF;
 
-	VB2_TRY(vb2_read_gbb_header(ctx, gbb));
+	start_ms = vb2ex_mtime();
+	rv = vb2_read_gbb_header(ctx, gbb);
+	vb2_timing_end(ctx, VB2_TIMING_GBB_READ, start_ms,
+		       rv ? 0 : sizeof(*gbb));
+	VB2_TRY(rv);
 
 	/* Keep on the work buffer permanently */
 	sd->gbb_offset = vb2_offset_of(sd, gbb);
@@ -556,6 +563,8 @@ void vb2api_export_vbsd(struct vb2_context *ctx, void *dest)
 		vbsd->firmware_index = 0xff;
 	else
 		vbsd->firmware_index = sd->fw_slot;
+
+	memcpy(vbsd->boot_timing, &sd->timing, sizeof(sd->timing));
 }
 _Static_assert(VB2_VBSD_SIZE == sizeof(VbSharedDataHeader),
 	       "VB2_VBSD_SIZE incorrect");
@@ -825,3 +834,35 @@ bool vb2_need_kernel_verification(struct vb2_context *ctx)
 
 	return false;
 }
+
+void vb2_timing_add(struct vb2_context *ctx, enum vb2_timing_phase phase,
+		    uint32_t start_ms, uint32_t elapsed_ms, uint32_t bytes)
+{
+	struct vb2_timing_phase_record *rec =
+		&vb2_get_sd(ctx)->timing.phase[phase];
+
+	if (!rec->count)
+		rec->start_ms = start_ms;
+	rec->count++;
+	rec->elapsed_ms += elapsed_ms;
+	rec->bytes += bytes;
+}
+
+void vb2_timing_kernel_try(struct vb2_context *ctx, uint32_t partition,
+			   uint32_t start_ms, uint32_t bytes,
+			   vb2_error_t result)
+{
+	struct vb2_boot_timing *timing = &vb2_get_sd(ctx)->timing;
+	struct vb2_timing_kernel_try *rec;
+
+	/* Count every try, even if there's no room left to record it */
+	if (timing->kernel_try_count < VB2_TIMING_MAX_KERNEL_TRIES) {
+		rec = &timing->kernel_try[timing->kernel_try_count];
+		rec->partition = partition;
+		rec->start_ms = start_ms;
+		rec->elapsed_ms = vb2ex_mtime() - start_ms;
+		rec->bytes = bytes;
+		rec->result = result;
+	}
+	timing->kernel_try_count++;
+}
@@ -0,0 +1,195 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * RSA public exponentiation with 64-bit limbs for hosts that have a native
+ * 64x64->128 multiplier.
+ *
+ * The pre-processed key stores n[] and RR as little endian arrays of 32-bit
+ * words.  Keys always have an even number of words, so pairs of words are
+ * exactly 64-bit limbs and R = 2^(32 * arrsize) is unchanged.  Only the
+ * Montgomery constant needs to be extended from -1/n mod 2^32 to
+ * -1/n mod 2^64.  Every Montgomery product is fully reduced, so the result
+ * is bit-for-bit the one vb2_modexp32() computes.
+ */
+
+#include "2common.h"
+#include "2rsa.h"
+#include "2rsa_private.h"
+#include "2sysincludes.h"
+
+typedef unsigned __int128 vb2_u128;
+
+/* Largest supported modulus (RSA-8192) in 64-bit limbs */
+#define MAX_LIMBS (8192 / 64)
+
+struct mont64_ctx {
+	uint32_t limbs;
+	uint64_t n0inv;
+	uint64_t n[MAX_LIMBS];
+};
+
+/**
+ * c[] -= n[], returning the borrow.
+ */
+static uint64_t sub_n(const struct mont64_ctx *ctx, uint64_t *c)
+{
+	uint64_t borrow = 0;
+	uint32_t i;
+
+	for (i = 0; i < ctx->limbs; i++) {
+		vb2_u128 d = (vb2_u128)c[i] - ctx->n[i] - borrow;
+		c[i] = (uint64_t)d;
+		borrow = (uint64_t)(d >> 64) & 1;
+	}
+
+	return borrow;
+}
+
+/**
+ * Return c[] >= n[].
+ */
+static int ge_n(const struct mont64_ctx *ctx, const uint64_t *c)
+{
+	uint32_t i;
+
+	for (i = ctx->limbs; i;) {
+		--i;
+		if (c[i] != ctx->n[i])
+			return c[i] > ctx->n[i];
+	}
+	return 1;  /* equal */
+}
+
+/**
+ * Montgomery c[] = a[] * b[] / R mod n, fully reduced (c < n).
+ *
+ * Coarsely integrated operand scanning.  One of a[] and b[] must be < n and
+ * the other < R, which keeps the unreduced result below 2n.  c[] may not
+ * alias a[] or b[].
+ */
+static void mont_mul(const struct mont64_ctx *ctx, uint64_t *c,
+		     const uint64_t *a, const uint64_t *b)
+{
+	const uint32_t s = ctx->limbs;
+	uint64_t top = 0;
+	uint32_t i, j;
+
+	for (j = 0; j < s; j++)
+		c[j] = 0;
+
+	for (i = 0; i < s; i++) {
+		const uint64_t bi = b[i];
+		vb2_u128 x = (vb2_u128)a[0] * bi + c[0];
+		const uint64_t m = (uint64_t)x * ctx->n0inv;
+		vb2_u128 y = (vb2_u128)m * ctx->n[0] + (uint64_t)x;
+
+		for (j = 1; j < s; j++) {
+			x = (x >> 64) + (vb2_u128)a[j] * bi + c[j];
+			y = (y >> 64) + (vb2_u128)m * ctx->n[j] + (uint64_t)x;
+			c[j - 1] = (uint64_t)y;
+		}
+
+		x = (x >> 64) + (y >> 64) + top;
+		c[s - 1] = (uint64_t)x;
+		top = (uint64_t)(x >> 64);
+	}
+
+	if (top || ge_n(ctx, c))
+		sub_n(ctx, c);
+}
+
+/* Little endian 32-bit words to 64-bit limbs */
+static void to_limbs(uint64_t *out, const uint32_t *in, uint32_t limbs)
+{
+	uint32_t i;
+
+	for (i = 0; i < limbs; i++)
+		out[i] = in[2 * i] | (uint64_t)in[2 * i + 1] << 32;
+}
+
+static void init_ctx(const struct vb2_public_key *key, struct mont64_ctx *ctx)
+{
+	uint64_t inv;
+
+	ctx->limbs = key->arrsize / 2;
+	to_limbs(ctx->n, key->n, ctx->limbs);
+
+	/*
+	 * -n0inv is 1/n mod 2^32; one Newton step doubles the number of
+	 * correct low bits, giving 1/n mod 2^64.
+	 */
+	inv = (uint32_t)-key->n0inv;
+	inv *= 2 - ctx->n[0] * inv;
+	ctx->n0inv = -inv;
+}
+
+/**
+ * Exponentiate inout[] in place.  rr[] is RR in limbs.
+ */
+static void modexp(const struct mont64_ctx *ctx, const uint64_t *rr,
+		   uint8_t *inout, int exp)
+{
+	uint64_t a[MAX_LIMBS], aR[MAX_LIMBS], aaR[MAX_LIMBS];
+	uint64_t *aaa = aaR;  /* Re-use location. */
+	uint32_t s = ctx->limbs;
+	int i, j;
+
+	/* Convert from big endian byte array to little endian limb array. */
+	for (i = 0; i < (int)s; i++) {
+		uint64_t tmp = 0;
+		for (j = 0; j < 8; j++)
+			tmp = tmp << 8 | inout[(s - 1 - i) * 8 + j];
+		a[i] = tmp;
+	}
+
+	mont_mul(ctx, aR, a, rr);  /* aR = a * RR / R mod M */
+	if (exp == 3) {
+		mont_mul(ctx, aaR, aR, aR);  /* aaR = aR * aR / R mod M */
+		mont_mul(ctx, a, aaR, aR);  /* a = aaR * aR / R mod M */
+		/* aaa = a * 1 / R mod M, with aR holding 1 */
+		for (i = 0; i < (int)s; i++)
+			aR[i] = !i;
+		mont_mul(ctx, aaa, aR, a);
+	} else {
+		/* Exponent 65537 */
+		for (i = 0; i < 16; i += 2) {
+			mont_mul(ctx, aaR, aR, aR);  /* aaR = aR * aR / R */
+			mont_mul(ctx, aR, aaR, aaR);  /* aR = aaR * aaR / R */
+		}
+		mont_mul(ctx, aaa, aR, a);  /* aaa = aR * a / R mod M */
+	}
+
+	/* Convert to big endian byte array */
+	for (i = (int)s - 1; i >= 0; --i) {
+		uint64_t tmp = aaa[i];
+		for (j = 56; j >= 0; j -= 8)
+			*inout++ = (uint8_t)(tmp >> j);
+	}
+}
+
+void vb2_modexp64(const struct vb2_public_key *key, uint8_t *inout, int exp)
+{
+	struct mont64_ctx ctx;
+	uint64_t rr[MAX_LIMBS];
+
+	init_ctx(key, &ctx);
+	to_limbs(rr, key->rr, ctx.limbs);
+	modexp(&ctx, rr, inout, exp);
+}
+
+void vb2_modexp64_batch(const struct vb2_public_key *key,
+			uint8_t *const inouts[], uint32_t count, int exp)
+{
+	struct mont64_ctx ctx;
+	uint64_t rr[MAX_LIMBS];
+	uint32_t i;
+
+	init_ctx(key, &ctx);
+	to_limbs(rr, key->rr, ctx.limbs);
+
+	for (i = 0; i < count; i++) {
+		if (inouts[i])
+			modexp(&ctx, rr, inouts[i], exp);
+	}
+}
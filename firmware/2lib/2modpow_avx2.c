@@ -0,0 +1,297 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * RSA public exponentiation with AVX2 Montgomery multiplication.
+ *
+ * The SSE2 implementation keeps 32-bit words and resolves the carry of every
+ * word product before the next one, which serializes each row of the
+ * multiplication.  Here numbers are split into 29-bit digits held in 64-bit
+ * lanes instead.  A digit product is below 2^58, so a lane can absorb many of
+ * them before it could overflow, and a row a[] * b[j] + n[] * q becomes
+ * independent multiply-adds four lanes at a time with no carries at all.
+ * Carries are only resolved for the one digit a row shifts out, and across
+ * the accumulator every NORMALIZE_ROWS rows.  Rather than shifting the
+ * accumulator down a digit per row, each row is added one digit further in.
+ *
+ * With 29-bit digits the Montgomery radix is R' = 2^(29 * digits) rather than
+ * the R = 2^(32 * arrsize) the key's RR was computed for, so R'R' mod n is
+ * derived from RR with a few modular doublings.
+ *
+ * This file must be compiled with -mavx2, and vb2_modexp_avx2() must only be
+ * called when vb2_modexp_avx2_supported() returns true.
+ */
+
+#include "2api.h"
+#include "2common.h"
+#include "2cpu.h"
+#include "2return_codes.h"
+#include "2rsa.h"
+#include "2rsa_private.h"
+
+typedef uint32_t vb2_v4su __attribute__((__vector_size__(16)));
+typedef uint64_t vb2_v4du __attribute__((__vector_size__(32)));
+typedef int vb2_v8si __attribute__((__vector_size__(32)));
+
+#define DIGIT_BITS 29
+#define DIGIT_MASK ((1u << DIGIT_BITS) - 1)
+#define LANES 4
+
+/*
+ * Rows accumulated between carry normalizations.  A row adds less than 2^59
+ * to a lane, so 16 rows on top of a normalized digit stay below 2^64.
+ */
+#define NORMALIZE_ROWS 16
+
+struct mont_avx2_ctx {
+	uint32_t digits;	/* Digits of the modulus */
+	uint32_t padded;	/* digits rounded up to a multiple of LANES */
+	uint32_t n0inv;		/* -1 / n mod 2^29 */
+	const uint32_t *n;	/* Modulus, padded with zero digits */
+	uint64_t *acc;		/* 2 * padded accumulator lanes */
+};
+
+/* Load four digits, zero extended to 64-bit lanes. */
+static inline vb2_v4du __attribute__((__always_inline__))
+load_digits(const uint32_t *p)
+{
+	vb2_v4su v;
+
+	memcpy(&v, p, sizeof(v));
+	return __builtin_convertvector(v, vb2_v4du);
+}
+
+/* Multiply the low 32 bits of each lane into a 64-bit product. */
+static inline vb2_v4du __attribute__((__always_inline__))
+mul_epu32(vb2_v4du a, vb2_v4du b)
+{
+	return (vb2_v4du)__builtin_ia32_pmuludq256((vb2_v8si)a, (vb2_v8si)b);
+}
+
+/**
+ * Reduce acc[0..count-1] to 29-bit digits, adding the final carry to
+ * acc[count].
+ */
+static void normalize(uint64_t *acc, uint32_t count)
+{
+	uint64_t carry = 0;
+	uint32_t i;
+
+	for (i = 0; i < count; i++) {
+		uint64_t v = acc[i] + carry;
+		acc[i] = v & DIGIT_MASK;
+		carry = v >> DIGIT_BITS;
+	}
+	acc[count] += carry;
+}
+
+/**
+ * Return c[] >= n[].
+ */
+static int ge_n(const struct mont_avx2_ctx *ctx, const uint32_t *c)
+{
+	uint32_t i;
+
+	for (i = ctx->digits; i;) {
+		--i;
+		if (c[i] != ctx->n[i])
+			return c[i] > ctx->n[i];
+	}
+	return 1;  /* equal */
+}
+
+/**
+ * Montgomery c[] = a[] * b[] / R' mod n, fully reduced (c < n).
+ *
+ * One of a[] and b[] must be < n and the other < R', which keeps the
+ * unreduced result below 2n.  Padding digits of a[] must be zero; those of
+ * c[] are left untouched.
+ */
+static void mont_mul(const struct mont_avx2_ctx *ctx, uint32_t *c,
+		     const uint32_t *a, const uint32_t *b)
+{
+	const uint32_t k = ctx->digits;
+	uint64_t *acc = ctx->acc;
+	uint64_t carry = 0;
+	uint32_t borrow = 0;
+	uint32_t i, j;
+
+	memset(acc, 0, 2 * ctx->padded * sizeof(*acc));
+
+	for (j = 0; j < k; j++) {
+		uint64_t *t = acc + j;
+		const uint64_t bj = b[j];
+		const uint64_t q = ((t[0] + a[0] * bj) * ctx->n0inv) &
+			DIGIT_MASK;
+		const vb2_v4du vb = { bj, bj, bj, bj };
+		const vb2_v4du vq = { q, q, q, q };
+
+		for (i = 0; i < ctx->padded; i += LANES) {
+			vb2_v4du v;
+
+			memcpy(&v, t + i, sizeof(v));
+			v += mul_epu32(load_digits(a + i), vb) +
+				mul_epu32(load_digits(ctx->n + i), vq);
+			memcpy(t + i, &v, sizeof(v));
+		}
+
+		/* The low digit is now a multiple of 2^29; shift it out. */
+		t[1] += t[0] >> DIGIT_BITS;
+
+		if (j % NORMALIZE_ROWS == NORMALIZE_ROWS - 1)
+			normalize(t + 1, k - 1);
+	}
+
+	for (i = 0; i < k; i++) {
+		uint64_t v = acc[k + i] + carry;
+		c[i] = v & DIGIT_MASK;
+		carry = v >> DIGIT_BITS;
+	}
+
+	if (carry || ge_n(ctx, c)) {
+		for (i = 0; i < k; i++) {
+			uint32_t d = c[i] - ctx->n[i] - borrow;
+			c[i] = d & DIGIT_MASK;
+			borrow = d >> 31;
+		}
+	}
+}
+
+/* Little endian 32-bit words to 29-bit digits */
+static void to_digits(uint32_t *d, const uint32_t *w, uint32_t words,
+		      uint32_t digits)
+{
+	uint32_t i;
+
+	for (i = 0; i < digits; i++) {
+		const uint32_t idx = i * DIGIT_BITS / 32;
+		uint64_t v = 0;
+
+		if (idx < words)
+			v = w[idx];
+		if (idx + 1 < words)
+			v |= (uint64_t)w[idx + 1] << 32;
+		d[i] = (v >> (i * DIGIT_BITS % 32)) & DIGIT_MASK;
+	}
+}
+
+/* 29-bit digits to little endian 32-bit words */
+static void from_digits(uint32_t *w, const uint32_t *d, uint32_t words,
+			uint32_t digits)
+{
+	uint32_t i;
+
+	memset(w, 0, words * sizeof(*w));
+	for (i = 0; i < digits; i++) {
+		const uint32_t idx = i * DIGIT_BITS / 32;
+		const uint64_t v = (uint64_t)d[i] << (i * DIGIT_BITS % 32);
+
+		if (idx < words)
+			w[idx] |= (uint32_t)v;
+		if (idx + 1 < words)
+			w[idx + 1] |= (uint32_t)(v >> 32);
+	}
+}
+
+/* x = 2x mod n, for x < n */
+static void mod_double(const struct vb2_public_key *key, uint32_t *x)
+{
+	uint32_t carry = 0;
+	uint64_t borrow = 0;
+	uint32_t i;
+
+	for (i = 0; i < key->arrsize; i++) {
+		const uint32_t v = x[i];
+		x[i] = v << 1 | carry;
+		carry = v >> 31;
+	}
+
+	if (!carry && !vb2_mont_ge(key, x))
+		return;
+
+	for (i = 0; i < key->arrsize; i++) {
+		const uint64_t d = (uint64_t)x[i] - key->n[i] - borrow;
+		x[i] = (uint32_t)d;
+		borrow = (d >> 32) & 1;
+	}
+}
+
+bool vb2_modexp_avx2_supported(void)
+{
+	return vb2_cpu_has(VB2_CPU_X86_AVX2);
+}
+
+vb2_error_t vb2_modexp_avx2(const struct vb2_public_key *key, uint8_t *inout,
+			    void *workbuf, size_t workbuf_size, int exp)
+{
+	const uint32_t words = key->arrsize;
+	const uint32_t digits = (words * 32 + DIGIT_BITS - 1) / DIGIT_BITS;
+	const uint32_t padded = (digits + LANES - 1) & ~(LANES - 1);
+	struct mont_avx2_ctx ctx;
+	uint32_t *n = (uint32_t *)(((uintptr_t)workbuf + 0x7) & ~0x7);
+	uint32_t *a = n + padded;
+	uint32_t *aR = a + padded;
+	uint32_t *aaR = aR + padded;
+	uint32_t *aaa = aaR;  /* Re-use location. */
+	uint32_t *rr = aaR + padded;
+	uint64_t *acc = (uint64_t *)(rr + padded);
+	uint32_t *w = (uint32_t *)acc;  /* Words, only outside mont_mul() */
+	uint32_t i;
+
+	if ((void *)&acc[2 * padded] - workbuf > workbuf_size) {
+		VB2_DEBUG("ERROR - AVX2 modexp work buffer too small!\n");
+		return VB2_ERROR_WORKBUF_SMALL;
+	}
+
+	/* Padding digits must read as zero. */
+	memset(n, 0, (void *)acc - (void *)n);
+
+	ctx.digits = digits;
+	ctx.padded = padded;
+	ctx.n0inv = key->n0inv & DIGIT_MASK;
+	ctx.n = n;
+	ctx.acc = acc;
+	to_digits(n, key->n, words, digits);
+
+	/* Convert from big endian byte array to digits. */
+	for (i = 0; i < words; i++) {
+		const uint8_t *p = inout + (words - 1 - i) * 4;
+		w[i] = (uint32_t)p[0] << 24 | p[1] << 16 | p[2] << 8 | p[3];
+	}
+	to_digits(a, w, words, digits);
+
+	/* R'R' = RR * (R' / R)^2 mod n */
+	memcpy(w, key->rr, words * sizeof(*w));
+	for (i = 0; i < 2 * (digits * DIGIT_BITS - words * 32); i++)
+		mod_double(key, w);
+	to_digits(rr, w, words, digits);
+
+	mont_mul(&ctx, aR, a, rr);  /* aR = a * R'R' / R' mod M */
+	if (exp == 3) {
+		mont_mul(&ctx, aaR, aR, aR);  /* aaR = aR * aR / R' mod M */
+		mont_mul(&ctx, a, aaR, aR);  /* a = aaR * aR / R' mod M */
+		/* aaa = a * 1 / R' mod M */
+		for (i = 0; i < digits; i++)
+			rr[i] = !i;
+		mont_mul(&ctx, aaa, a, rr);
+	} else {
+		/* Exponent 65537 */
+		for (i = 0; i < 16; i += 2) {
+			mont_mul(&ctx, aaR, aR, aR);  /* aaR = aR * aR / R' */
+			mont_mul(&ctx, aR, aaR, aaR);  /* aR = aaR * aaR / R' */
+		}
+		mont_mul(&ctx, aaa, aR, a);  /* aaa = aR * a / R' mod M */
+	}
+
+	/* Convert to big endian byte array */
+	from_digits(w, aaa, words, digits);
+	for (i = 0; i < words; i++) {
+		const uint32_t v = w[words - 1 - i];
+		*inout++ = (uint8_t)(v >> 24);
+		*inout++ = (uint8_t)(v >> 16);
+		*inout++ = (uint8_t)(v >> 8);
+		*inout++ = (uint8_t)v;
+	}
+
+	return VB2_SUCCESS;
+}
@@ -23,6 +23,7 @@
 #include "2common.h"
 #include "2return_codes.h"
 #include "2rsa.h"
+#include "2rsa_private.h"
 
 typedef long long vb2_m128i __attribute__((__vector_size__(16), __may_alias__));
 typedef int vb2_v4si __attribute__((__vector_size__(16)));
@@ -164,9 +165,8 @@ static void swap_endianness(const uint32_t *in, uint32_t *out, size_t size)
 		out[i] = __builtin_bswap32(in[size - 1 - i]);
 }
 
-vb2_error_t vb2ex_hwcrypto_modexp(const struct vb2_public_key *key,
-				  uint8_t *inout, void *workbuf,
-				  size_t workbuf_size, int exp)
+vb2_error_t vb2_modexp_sse2(const struct vb2_public_key *key, uint8_t *inout,
+			    void *workbuf, size_t workbuf_size, int exp)
 {
 	const uint32_t mu = -key->n0inv;
 	uint32_t *a = workbuf;
@@ -218,3 +218,14 @@ vb2_error_t vb2ex_hwcrypto_modexp(const struct vb2_public_key *key,
 
 	return VB2_SUCCESS;
 }
+
+vb2_error_t vb2ex_hwcrypto_modexp(const struct vb2_public_key *key,
+				  uint8_t *inout, void *workbuf,
+				  size_t workbuf_size, int exp)
+{
+#ifdef VB2_X86_RSA_AVX2
+	if (vb2_modexp_avx2_supported())
+		return vb2_modexp_avx2(key, inout, workbuf, workbuf_size, exp);
+#endif
+	return vb2_modexp_sse2(key, inout, workbuf, workbuf_size, exp);
+}
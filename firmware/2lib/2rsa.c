@@ -124,9 +124,8 @@ static void montMul1(const struct vb2_public_key *key,
 		montMulAdd0(key, c, a);
 }
 
-test_mockable
-void vb2_modexp(const struct vb2_public_key *key, uint8_t *inout,
-		void *workbuf, int exp)
+void vb2_modexp32(const struct vb2_public_key *key, uint8_t *inout,
+		  void *workbuf, int exp)
 {
 	uint32_t *a = workbuf;
 	uint32_t *aR = a + key->arrsize;
@@ -174,6 +173,19 @@ void vb2_modexp(const struct vb2_public_key *key, uint8_t *inout,
 	}
 }
 
+test_mockable
+void vb2_modexp(const struct vb2_public_key *key, uint8_t *inout,
+		void *workbuf, int exp)
+{
+#ifdef VB2_MODEXP64
+	if (!(key->arrsize & 1) && key->arrsize <= 8192 / 32) {
+		vb2_modexp64(key, inout, exp);
+		return;
+	}
+#endif
+	vb2_modexp32(key, inout, workbuf, exp);
+}
+
 uint32_t vb2_rsa_sig_size(enum vb2_signature_algorithm sig_alg)
 {
 	switch (sig_alg) {
@@ -324,15 +336,73 @@ vb2_error_t vb2_check_padding(const uint8_t *sig,
 	return result ? VB2_ERROR_RSA_PADDING : VB2_SUCCESS;
 }
 
+/**
+ * Check that a key can verify signatures, returning its signature size and
+ * exponent.
+ */
+static vb2_error_t check_verify_key(const struct vb2_public_key *key,
+				    int *sig_size, int *exp)
+{
+	uint32_t key_bytes;
+
+	*sig_size = vb2_rsa_sig_size(key->sig_alg);
+	*exp = vb2_rsa_exponent(key->sig_alg);
+	if (!*sig_size || !*exp) {
+		VB2_DEBUG("Invalid signature type!\n");
+		return VB2_ERROR_RSA_VERIFY_ALGORITHM;
+	}
+
+	/* Signature length should be same as key length */
+	key_bytes = key->arrsize * sizeof(uint32_t);
+	if (key_bytes != *sig_size || key->arrsize > key_bytes) {
+		VB2_DEBUG("Signature is of incorrect length!\n");
+		return VB2_ERROR_RSA_VERIFY_SIG_LEN;
+	}
+
+	return VB2_SUCCESS;
+}
+
+/**
+ * Check the padding and digest of a signature after exponentiation.
+ */
+static vb2_error_t check_verify_result(const struct vb2_public_key *key,
+				       const uint8_t *sig,
+				       const uint8_t *digest, int sig_size)
+{
+	vb2_error_t rv;
+	int pad_size;
+
+	/*
+	 * Check padding.  Only fail immediately if the padding size is bad.
+	 * Otherwise, continue on to check the digest to reduce the risk of
+	 * timing based attacks.
+	 */
+	rv = vb2_check_padding(sig, key);
+	if (rv == VB2_ERROR_RSA_PADDING_SIZE)
+		return rv;
+
+	/*
+	 * Check digest.  Even though there are probably no timing issues here,
+	 * use vb2_safe_memcmp() just to be on the safe side.  (That's also why
+	 * we don't return before this check if the padding check failed.)
+	 */
+	pad_size = sig_size - vb2_digest_size(key->hash_alg);
+	if (vb2_safe_memcmp(sig + pad_size, digest, sig_size - pad_size)) {
+		VB2_DEBUG("Digest check failed!\n");
+		if (!rv)
+			rv = VB2_ERROR_RSA_VERIFY_DIGEST;
+	}
+
+	return rv;
+}
+
 vb2_error_t vb2_rsa_verify_digest(const struct vb2_public_key *key,
 				  uint8_t *sig, const uint8_t *digest,
 				  const struct vb2_workbuf *wb)
 {
 	struct vb2_workbuf wblocal = *wb;
 	void *workbuf;
-	uint32_t key_bytes;
 	int sig_size;
-	int pad_size;
 	size_t workbuf_size;
 	int exp;
 	vb2_error_t rv = VB2_ERROR_EX_HWCRYPTO_UNSUPPORTED;
@@ -340,21 +410,9 @@ vb2_error_t vb2_rsa_verify_digest(const struct vb2_public_key *key,
 	if (!key || !sig || !digest)
 		return VB2_ERROR_RSA_VERIFY_PARAM;
 
-	sig_size = vb2_rsa_sig_size(key->sig_alg);
-	exp = vb2_rsa_exponent(key->sig_alg);
-	if (!sig_size || !exp) {
-		VB2_DEBUG("Invalid signature type!\n");
-		return VB2_ERROR_RSA_VERIFY_ALGORITHM;
-	}
+	VB2_TRY(check_verify_key(key, &sig_size, &exp));
 
-	/* Signature length should be same as key length */
-	key_bytes = key->arrsize * sizeof(uint32_t);
-	if (key_bytes != sig_size || key->arrsize > key_bytes) {
-		VB2_DEBUG("Signature is of incorrect length!\n");
-		return VB2_ERROR_RSA_VERIFY_SIG_LEN;
-	}
-
-	workbuf_size = VB2_MAX(3 * key_bytes, vb2_wb_round_down(wblocal.size));
+	workbuf_size = VB2_MAX(3 * sig_size, vb2_wb_round_down(wblocal.size));
 	workbuf = vb2_workbuf_alloc(&wblocal, workbuf_size);
 	if (!workbuf) {
 		VB2_DEBUG("ERROR - vboot2 %zd bytes work buffer allocation failed!\n",
@@ -381,26 +439,85 @@ vb2_error_t vb2_rsa_verify_digest(const struct vb2_public_key *key,
 
 	vb2_workbuf_free(&wblocal, workbuf_size);
 
-	/*
-	 * Check padding.  Only fail immediately if the padding size is bad.
-	 * Otherwise, continue on to check the digest to reduce the risk of
-	 * timing based attacks.
-	 */
-	rv = vb2_check_padding(sig, key);
-	if (rv == VB2_ERROR_RSA_PADDING_SIZE)
+	return check_verify_result(key, sig, digest, sig_size);
+}
+
+vb2_error_t vb2_rsa_verify_digests(const struct vb2_public_key *key,
+				   uint8_t *const sigs[],
+				   const uint8_t *const digests[],
+				   uint32_t count, vb2_error_t results[],
+				   const struct vb2_workbuf *wb)
+{
+	struct vb2_workbuf wblocal = *wb;
+	void *workbuf;
+	int sig_size;
+	size_t workbuf_size;
+	int exp;
+	vb2_error_t rv = VB2_SUCCESS;
+	int hwcrypto = key && key->allow_hwcrypto;
+	int batched = 0;
+	uint32_t i;
+
+	if (!key || !sigs || !digests || !results)
+		rv = VB2_ERROR_RSA_VERIFY_PARAM;
+	else
+		rv = check_verify_key(key, &sig_size, &exp);
+
+	if (rv == VB2_SUCCESS) {
+		workbuf_size = VB2_MAX(3 * sig_size,
+				       vb2_wb_round_down(wblocal.size));
+		workbuf = vb2_workbuf_alloc(&wblocal, workbuf_size);
+		if (!workbuf) {
+			VB2_DEBUG("ERROR - vboot2 %zd bytes work buffer allocation failed!\n",
+				  workbuf_size);
+			rv = VB2_ERROR_RSA_VERIFY_WORKBUF;
+		}
+	}
+
+	if (rv != VB2_SUCCESS) {
+		for (i = 0; results && i < count; i++)
+			results[i] = rv;
 		return rv;
+	}
 
+#ifdef VB2_MODEXP64
 	/*
-	 * Check digest.  Even though there are probably no timing issues here,
-	 * use vb2_safe_memcmp() just to be on the safe side.  (That's also why
-	 * we don't return before this check if the padding check failed.)
+	 * Without a hardware engine, exponentiate everything up front so the
+	 * signatures share one Montgomery context.
 	 */
-	pad_size = sig_size - vb2_digest_size(key->hash_alg);
-	if (vb2_safe_memcmp(sig + pad_size, digest, key_bytes - pad_size)) {
-		VB2_DEBUG("Digest check failed!\n");
-		if (!rv)
-			rv = VB2_ERROR_RSA_VERIFY_DIGEST;
+	if (!hwcrypto && !(key->arrsize & 1) && key->arrsize <= 8192 / 32 &&
+	    count > 1) {
+		vb2_modexp64_batch(key, sigs, count, exp);
+		batched = 1;
 	}
+#endif
+
+	for (i = 0; i < count; i++) {
+		vb2_error_t hwrv = VB2_ERROR_EX_HWCRYPTO_UNSUPPORTED;
+
+		if (!sigs[i] || !digests[i]) {
+			results[i] = VB2_ERROR_RSA_VERIFY_PARAM;
+		} else {
+			if (hwcrypto) {
+				hwrv = vb2ex_hwcrypto_modexp(key, sigs[i],
+							     workbuf,
+							     workbuf_size, exp);
+				/* Don't retry an engine that can't do this */
+				if (hwrv == VB2_ERROR_EX_HWCRYPTO_UNSUPPORTED)
+					hwcrypto = 0;
+			}
+			if (hwrv != VB2_SUCCESS && !batched)
+				vb2_modexp(key, sigs[i], workbuf, exp);
+
+			results[i] = check_verify_result(key, sigs[i],
+							 digests[i], sig_size);
+		}
+
+		if (rv == VB2_SUCCESS)
+			rv = results[i];
+	}
+
+	vb2_workbuf_free(&wblocal, workbuf_size);
 
 	return rv;
 }
@@ -8,6 +8,7 @@
 
 #include "2common.h"
 #include "2sha.h"
+#include "2sha_private.h"
 #include "2sysincludes.h"
 
 /*
@@ -194,6 +195,13 @@ static void sha1_transform(struct vb2_sha1_context *ctx)
 	uint8_t *p = ctx->buf;
 	int t;
 
+#ifdef ARMV8_SHA_CE
+	if (vb2_sha1_armv8_supported()) {
+		vb2_sha1_transform_armv8(ctx->state, ctx->buf, 1);
+		return;
+	}
+#endif
+
 	for (t = 0; t < 16; ++t) {
 		uint32_t tmp = (uint32_t)*p++ << 24;
 		tmp |= *p++ << 16;
@@ -139,6 +139,13 @@ static void vb2_sha256_transform(struct vb2_sha256_context *ctx,
 	int j;
 #endif
 
+#ifdef X86_SHA_AVX2
+	if (block_nb > 1 && vb2_sha_avx2_supported()) {
+		vb2_sha256_transform_avx2(ctx->h, message, block_nb);
+		return;
+	}
+#endif
+
 	for (i = 0; i < (int) block_nb; i++) {
 		sub_block = message + (i << 6);
 
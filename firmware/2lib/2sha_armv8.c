@@ -0,0 +1,27 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Runtime checks for the ARMv8 SHA-1 and SHA-512 transforms.
+ *
+ * SHA-1 is part of the ARMv8 Cryptography Extension, but SHA-512 is an
+ * optional ARMv8.2 feature, so both are probed at runtime.
+ */
+
+#include "2common.h"
+#include "2cpu.h"
+#include "2sha.h"
+#include "2sha_private.h"
+#include "2sysincludes.h"
+
+bool vb2_sha1_armv8_supported(void)
+{
+	return (vb2_sha_accel_mask & VB2_SHA_ACCEL_ARMV8) &&
+		vb2_cpu_has(VB2_CPU_ARM_SHA1);
+}
+
+bool vb2_sha512_armv8_supported(void)
+{
+	return (vb2_sha_accel_mask & VB2_SHA_ACCEL_ARMV8) &&
+		vb2_cpu_has(VB2_CPU_ARM_SHA512);
+}
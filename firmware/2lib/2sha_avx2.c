@@ -0,0 +1,274 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * SHA-256 and SHA-512 block transforms with an AVX2 message schedule.
+ *
+ * The message schedule of a block only depends on the block's own data, so
+ * the schedules of several consecutive blocks can be expanded at once with
+ * one block per vector lane (8 lanes for SHA-256, 4 for SHA-512).  The
+ * compression rounds, which depend on the previous block's result, are then
+ * run one block at a time with the precomputed W[t] + K[t] values.
+ *
+ * vb2_sha256_multi_transform_avx2() instead hashes eight independent
+ * messages, one per lane, running the whole compression function in vectors.
+ *
+ * This file must be compiled with -mavx2, and the transforms must only be
+ * called when vb2_sha_avx2_supported() returns true.
+ */
+
+#include "2common.h"
+#include "2cpu.h"
+#include "2sha.h"
+#include "2sha_private.h"
+#include "2sysincludes.h"
+
+#define SHA256_LANES 8
+#define SHA512_LANES 4
+
+typedef uint32_t vb2_v8su __attribute__((__vector_size__(32)));
+typedef uint64_t vb2_v4du __attribute__((__vector_size__(32)));
+
+#define ROTR(x, n, bits)	(((x) >> (n)) | ((x) << ((bits) - (n))))
+#define CH(x, y, z)		(((x) & (y)) ^ (~(x) & (z)))
+#define MAJ(x, y, z)		(((x) & (y)) ^ ((x) & (z)) ^ ((y) & (z)))
+
+#define SHA256_F1(x) (ROTR(x,  2, 32) ^ ROTR(x, 13, 32) ^ ROTR(x, 22, 32))
+#define SHA256_F2(x) (ROTR(x,  6, 32) ^ ROTR(x, 11, 32) ^ ROTR(x, 25, 32))
+#define SHA256_F3(x) (ROTR(x,  7, 32) ^ ROTR(x, 18, 32) ^ ((x) >>  3))
+#define SHA256_F4(x) (ROTR(x, 17, 32) ^ ROTR(x, 19, 32) ^ ((x) >> 10))
+
+#define SHA512_F1(x) (ROTR(x, 28, 64) ^ ROTR(x, 34, 64) ^ ROTR(x, 39, 64))
+#define SHA512_F2(x) (ROTR(x, 14, 64) ^ ROTR(x, 18, 64) ^ ROTR(x, 41, 64))
+#define SHA512_F3(x) (ROTR(x,  1, 64) ^ ROTR(x,  8, 64) ^ ((x) >>  7))
+#define SHA512_F4(x) (ROTR(x, 19, 64) ^ ROTR(x, 61, 64) ^ ((x) >>  6))
+
+/* One compression round; callers rotate the variable names instead of the
+   values, eight rounds at a time. */
+#define SHA256_RND(a, b, c, d, e, f, g, h, wk)				\
+	{								\
+		t1 = h + SHA256_F2(e) + CH(e, f, g) + (wk);		\
+		t2 = SHA256_F1(a) + MAJ(a, b, c);			\
+		d += t1;						\
+		h = t1 + t2;						\
+	}
+
+#define SHA512_RND(a, b, c, d, e, f, g, h, wk)				\
+	{								\
+		t1 = h + SHA512_F2(e) + CH(e, f, g) + (wk);		\
+		t2 = SHA512_F1(a) + MAJ(a, b, c);			\
+		d += t1;						\
+		h = t1 + t2;						\
+	}
+
+#define ROUNDS_8(RND, WK, j)						\
+	{								\
+		RND(a, b, c, d, e, f, g, h, WK((j) + 0));		\
+		RND(h, a, b, c, d, e, f, g, WK((j) + 1));		\
+		RND(g, h, a, b, c, d, e, f, WK((j) + 2));		\
+		RND(f, g, h, a, b, c, d, e, WK((j) + 3));		\
+		RND(e, f, g, h, a, b, c, d, WK((j) + 4));		\
+		RND(d, e, f, g, h, a, b, c, WK((j) + 5));		\
+		RND(c, d, e, f, g, h, a, b, WK((j) + 6));		\
+		RND(b, c, d, e, f, g, h, a, WK((j) + 7));		\
+	}
+
+/* W[t] + K[t] of the block in lane i of the expanded schedules */
+#define LANE_WK(t) wk[t][i]
+
+bool vb2_sha_avx2_supported(void)
+{
+	return (vb2_sha_accel_mask & VB2_SHA_ACCEL_AVX2) &&
+		vb2_cpu_has(VB2_CPU_X86_AVX2);
+}
+
+/*
+ * Expand the message schedules of `lanes` consecutive SHA-256 blocks and
+ * fold in the round constants, so wk[t][i] = W[t] + K[t] for block i.
+ */
+static void sha256_schedule(const uint8_t *message, unsigned int lanes,
+			    vb2_v8su wk[64])
+{
+	int i, t;
+
+	for (t = 0; t < 16; t++) {
+		for (i = 0; i < SHA256_LANES; i++) {
+			uint32_t w = 0;
+
+			if (i < lanes)
+				PACK32(&message[(i << 6) + (t << 2)], &w);
+			wk[t][i] = w;
+		}
+	}
+
+	for (t = 16; t < 64; t++) {
+		wk[t] = SHA256_F4(wk[t - 2]) + wk[t - 7] +
+			SHA256_F3(wk[t - 15]) + wk[t - 16];
+		/* W[t - 16] is not needed for any later word. */
+		wk[t - 16] += vb2_sha256_k[t - 16];
+	}
+
+	for (t = 48; t < 64; t++)
+		wk[t] += vb2_sha256_k[t];
+}
+
+void vb2_sha256_transform_avx2(uint32_t *state, const uint8_t *message,
+			       unsigned int block_nb)
+{
+	/* 64 * 32 = 2 KB of stack; this is host-only code. */
+	vb2_v8su wk[64];
+	uint32_t a, b, c, d, e, f, g, h;
+	uint32_t t1, t2;
+	unsigned int lanes, i;
+	int j;
+
+	while (block_nb) {
+		lanes = VB2_MIN(block_nb, SHA256_LANES);
+		sha256_schedule(message, lanes, wk);
+
+		for (i = 0; i < lanes; i++) {
+			a = state[0]; b = state[1]; c = state[2]; d = state[3];
+			e = state[4]; f = state[5]; g = state[6]; h = state[7];
+
+			for (j = 0; j < 64; j += 8)
+				ROUNDS_8(SHA256_RND, LANE_WK, j);
+
+			state[0] += a; state[1] += b;
+			state[2] += c; state[3] += d;
+			state[4] += e; state[5] += f;
+			state[6] += g; state[7] += h;
+		}
+
+		message += lanes << 6;
+		block_nb -= lanes;
+	}
+}
+
+/*
+ * Expand the message schedules of `lanes` consecutive SHA-512 blocks and
+ * fold in the round constants, so wk[t][i] = W[t] + K[t] for block i.
+ */
+static void sha512_schedule(const uint8_t *message, unsigned int lanes,
+			    vb2_v4du wk[80])
+{
+	int i, t;
+
+	for (t = 0; t < 16; t++) {
+		for (i = 0; i < SHA512_LANES; i++) {
+			uint64_t w = 0;
+
+			if (i < lanes) {
+				memcpy(&w, &message[(i << 7) + (t << 3)],
+				       sizeof(w));
+				w = __builtin_bswap64(w);
+			}
+			wk[t][i] = w;
+		}
+	}
+
+	for (t = 16; t < 80; t++) {
+		wk[t] = SHA512_F4(wk[t - 2]) + wk[t - 7] +
+			SHA512_F3(wk[t - 15]) + wk[t - 16];
+		/* W[t - 16] is not needed for any later word. */
+		wk[t - 16] += vb2_sha512_k[t - 16];
+	}
+
+	for (t = 64; t < 80; t++)
+		wk[t] += vb2_sha512_k[t];
+}
+
+void vb2_sha512_transform_avx2(uint64_t *state, const uint8_t *message,
+			       unsigned int block_nb)
+{
+	/* 80 * 32 = 2.5 KB of stack; this is host-only code. */
+	vb2_v4du wk[80];
+	uint64_t a, b, c, d, e, f, g, h;
+	uint64_t t1, t2;
+	unsigned int lanes, i;
+	int j;
+
+	while (block_nb) {
+		lanes = VB2_MIN(block_nb, SHA512_LANES);
+		sha512_schedule(message, lanes, wk);
+
+		for (i = 0; i < lanes; i++) {
+			a = state[0]; b = state[1]; c = state[2]; d = state[3];
+			e = state[4]; f = state[5]; g = state[6]; h = state[7];
+
+			for (j = 0; j < 80; j += 8)
+				ROUNDS_8(SHA512_RND, LANE_WK, j);
+
+			state[0] += a; state[1] += b;
+			state[2] += c; state[3] += d;
+			state[4] += e; state[5] += f;
+			state[6] += g; state[7] += h;
+		}
+
+		message += lanes << 7;
+		block_nb -= lanes;
+	}
+}
+
+/*
+ * Return W[t] + K[t] for eight independent SHA-256 messages.  For t >= 16,
+ * W[t] is computed in place of W[t - 16] in the 16-word ring buffer.
+ */
+static inline vb2_v8su sha256_multi_wk(vb2_v8su w[16], int t)
+{
+	if (t >= 16)
+		w[t & 15] += SHA256_F4(w[(t - 2) & 15]) + w[(t - 7) & 15] +
+			SHA256_F3(w[(t - 15) & 15]);
+
+	return w[t & 15] + vb2_sha256_k[t];
+}
+
+#define MULTI_WK(t) sha256_multi_wk(w, t)
+
+void vb2_sha256_multi_transform_avx2(
+	uint32_t state[8][VB2_SHA256_MULTI_LANES],
+	const uint8_t *const data[VB2_SHA256_MULTI_LANES],
+	unsigned int block_nb)
+{
+	vb2_v8su w[16];
+	vb2_v8su a, b, c, d, e, f, g, h;
+	vb2_v8su t1, t2;
+	unsigned int n;
+	int i, j;
+
+	memcpy(&a, state[0], sizeof(a));
+	memcpy(&b, state[1], sizeof(b));
+	memcpy(&c, state[2], sizeof(c));
+	memcpy(&d, state[3], sizeof(d));
+	memcpy(&e, state[4], sizeof(e));
+	memcpy(&f, state[5], sizeof(f));
+	memcpy(&g, state[6], sizeof(g));
+	memcpy(&h, state[7], sizeof(h));
+
+	for (n = 0; n < block_nb; n++) {
+		vb2_v8su wv[8] = { a, b, c, d, e, f, g, h };
+
+		for (j = 0; j < 16; j++) {
+			for (i = 0; i < VB2_SHA256_MULTI_LANES; i++) {
+				uint32_t x;
+
+				PACK32(&data[i][(n << 6) + (j << 2)], &x);
+				w[j][i] = x;
+			}
+		}
+
+		for (j = 0; j < 64; j += 8)
+			ROUNDS_8(SHA256_RND, MULTI_WK, j);
+
+		a += wv[0]; b += wv[1]; c += wv[2]; d += wv[3];
+		e += wv[4]; f += wv[5]; g += wv[6]; h += wv[7];
+	}
+
+	memcpy(state[0], &a, sizeof(a));
+	memcpy(state[1], &b, sizeof(b));
+	memcpy(state[2], &c, sizeof(c));
+	memcpy(state[3], &d, sizeof(d));
+	memcpy(state[4], &e, sizeof(e));
+	memcpy(state[5], &f, sizeof(f));
+	memcpy(state[6], &g, sizeof(g));
+	memcpy(state[7], &h, sizeof(h));
+}
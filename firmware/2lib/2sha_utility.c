@@ -7,8 +7,11 @@
 
 #include "2common.h"
 #include "2sha.h"
+#include "2sha_private.h"
 #include "2sysincludes.h"
 
+uint32_t vb2_sha_accel_mask = ~0U;
+
 size_t vb2_digest_size(enum vb2_hash_algorithm hash_alg)
 {
 	switch (hash_alg) {
@@ -191,3 +194,102 @@ vb2_error_t vb2_hash_verify(bool allow_hwcrypto, const void *buf, uint32_t size,
 	else
 		return VB2_SUCCESS;
 }
+
+#ifdef X86_SHA_AVX2
+/*
+ * Hash up to VB2_SHA256_MULTI_LANES freshly initialized SHA-256 contexts
+ * together.  Full blocks go through the multi-lane transform for as long as
+ * at least two lanes have some left; vb2_sha256_update() does the rest.
+ */
+static void sha256_update_lanes(struct vb2_sha256_context *ctx,
+				const uint8_t *const bufs[],
+				const uint32_t sizes[], int count)
+{
+	uint32_t state[8][VB2_SHA256_MULTI_LANES] = {0};
+	const uint8_t *data[VB2_SHA256_MULTI_LANES];
+	const uint8_t *lanes[VB2_SHA256_MULTI_LANES];
+	uint32_t left[VB2_SHA256_MULTI_LANES];
+	uint32_t step;
+	int active, first, i, j;
+
+	for (i = 0; i < count; i++) {
+		left[i] = sizes[i] / VB2_SHA256_BLOCK_SIZE;
+		data[i] = bufs[i];
+		for (j = 0; j < 8; j++)
+			state[j][i] = ctx[i].h[j];
+	}
+
+	while (1) {
+		active = 0;
+		first = -1;
+		step = UINT32_MAX;
+		for (i = 0; i < count; i++) {
+			if (!left[i])
+				continue;
+			if (first < 0)
+				first = i;
+			active++;
+			step = VB2_MIN(step, left[i]);
+		}
+		if (active < 2)
+			break;
+
+		/* Idle lanes hash a copy of an active lane's data. */
+		for (i = 0; i < VB2_SHA256_MULTI_LANES; i++)
+			lanes[i] = i < count && left[i] ? data[i] : data[first];
+
+		vb2_sha256_multi_transform_avx2(state, lanes, step);
+
+		for (i = 0; i < count; i++) {
+			if (!left[i])
+				continue;
+			for (j = 0; j < 8; j++)
+				ctx[i].h[j] = state[j][i];
+			ctx[i].total_size += step * VB2_SHA256_BLOCK_SIZE;
+			data[i] += step * VB2_SHA256_BLOCK_SIZE;
+			left[i] -= step;
+		}
+	}
+
+	for (i = 0; i < count; i++)
+		vb2_sha256_update(&ctx[i], data[i],
+				  sizes[i] - ctx[i].total_size);
+}
+#endif
+
+vb2_error_t vb2_hash_calculate_multi(bool allow_hwcrypto,
+				     const void *const bufs[],
+				     const uint32_t sizes[], uint32_t count,
+				     enum vb2_hash_algorithm algo,
+				     struct vb2_hash hashes[])
+{
+	uint32_t i = 0;
+
+#ifdef X86_SHA_AVX2
+	if (!allow_hwcrypto &&
+	    (algo == VB2_HASH_SHA256 || algo == VB2_HASH_SHA224) &&
+	    vb2_sha_avx2_supported()) {
+		struct vb2_sha256_context ctx[VB2_SHA256_MULTI_LANES];
+		uint32_t n, j;
+
+		for (; count - i >= 2; i += n) {
+			n = VB2_MIN(count - i, VB2_SHA256_MULTI_LANES);
+			for (j = 0; j < n; j++)
+				vb2_sha256_init(&ctx[j], algo);
+			sha256_update_lanes(ctx, (const uint8_t *const *)
+					    &bufs[i], &sizes[i], n);
+			for (j = 0; j < n; j++) {
+				hashes[i + j].algo = algo;
+				vb2_sha256_finalize(&ctx[j], hashes[i + j].raw,
+						    algo);
+			}
+		}
+	}
+#endif
+
+	for (; i < count; i++)
+		VB2_TRY(vb2_hash_calculate(allow_hwcrypto, bufs[i], sizes[i],
+					   algo, &hashes[i]));
+
+	return VB2_SUCCESS;
+}
@@ -0,0 +1,23 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Stub asynchronous stream API implementations, for firmware which only
+ * provides the synchronous VbExStreamRead().
+ */
+
+#include "2api.h"
+#include "vboot_api.h"
+
+__attribute__((weak))
+vb2_error_t VbExStreamReadAsync(VbExStream_t stream, uint32_t bytes,
+				void *buffer)
+{
+	return VB2_ERROR_EX_UNIMPLEMENTED;
+}
+
+__attribute__((weak))
+vb2_error_t VbExStreamWaitAsync(VbExStream_t stream)
+{
+	return VB2_ERROR_EX_UNIMPLEMENTED;  /* Should not be called. */
+}
@@ -381,6 +381,25 @@ vb2_error_t vb2_verify_digest(const struct vb2_public_key *key,
 			      struct vb2_signature *sig, const uint8_t *digest,
 			      const struct vb2_workbuf *wb);
 
+/**
+ * Verify several signatures made with the same key against their digests.
+ *
+ * See vb2_rsa_verify_digests().
+ *
+ * @param key		Key to use in signature verification
+ * @param sigs		Signatures to verify (may be destroyed in process)
+ * @param digests	Digest of signed data, one per signature
+ * @param count		Number of signatures
+ * @param results	Receives the result of verifying each signature
+ * @param wb		Work buffer
+ * @return VB2_SUCCESS if every signature verified, else the first error.
+ */
+vb2_error_t vb2_verify_digests(const struct vb2_public_key *key,
+			       struct vb2_signature *const sigs[],
+			       const uint8_t *const digests[], uint32_t count,
+			       vb2_error_t results[],
+			       const struct vb2_workbuf *wb);
+
 /**
  * Verify data matches signature.
  *
@@ -98,6 +98,9 @@ typedef void *vb2ex_disk_handle_t;
    the struct definition as part of a vb2_api.h include. */
 #define VB2_VBSD_SIZE 1096
 
+/* Size of struct vb2_boot_timing, which is part of VbSharedDataHeader */
+#define VB2_BOOT_TIMING_SIZE 296
+
 /* Kernel image type */
 #define VB2_KERNEL_TYPE_MASK		0x00000003
 #define VB2_KERNEL_TYPE_CROS		0
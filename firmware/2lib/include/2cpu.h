@@ -0,0 +1,37 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * CPU feature probing for the accelerated implementations picked at runtime.
+ */
+
+#ifndef VBOOT_REFERENCE_2CPU_H_
+#define VBOOT_REFERENCE_2CPU_H_
+
+#include "2sysincludes.h"
+
+/*
+ * An accelerated implementation is only used if the CPU has the features it
+ * needs and its bit is set in the owning library's accel mask
+ * (vb2_sha_accel_mask, crc32_accel_mask).  The masks allow everything by
+ * default; tests and benchmarks clear bits to run the portable code instead.
+ */
+
+/* CPU features, as a mask of VB2_CPU_* bits */
+#define VB2_CPU_X86_AVX2 (1 << 0)
+#define VB2_CPU_X86_PCLMUL (1 << 1)
+#define VB2_CPU_ARM_SHA1 (1 << 2)
+#define VB2_CPU_ARM_SHA512 (1 << 3)
+#define VB2_CPU_ARM_CRC32 (1 << 4)
+
+/**
+ * Check whether the CPU has all of the given features.
+ *
+ * The CPU is probed on the first call, and the result reused afterwards.
+ *
+ * @param features	Mask of VB2_CPU_* bits
+ * @return true if every feature in the mask may be used.
+ */
+bool vb2_cpu_has(uint32_t features);
+
+#endif  /* VBOOT_REFERENCE_2CPU_H_ */
@@ -173,4 +173,46 @@ void vb2_set_boot_mode(struct vb2_context *ctx);
  */
 bool vb2_need_kernel_verification(struct vb2_context *ctx);
 
+/**
+ * Add time spent in a boot phase to the timing record in shared data.
+ *
+ * @param ctx		Vboot context
+ * @param phase		Phase which ran
+ * @param start_ms	vb2ex_mtime() when the phase started
+ * @param elapsed_ms	Time spent in the phase
+ * @param bytes		Number of bytes the phase processed
+ */
+void vb2_timing_add(struct vb2_context *ctx, enum vb2_timing_phase phase,
+		    uint32_t start_ms, uint32_t elapsed_ms, uint32_t bytes);
+
+/**
+ * Add a boot phase which started at start_ms and ends now to the timing
+ * record in shared data.
+ *
+ * @param ctx		Vboot context
+ * @param phase		Phase which ran
+ * @param start_ms	vb2ex_mtime() when the phase started
+ * @param bytes		Number of bytes the phase processed
+ */
+static inline void vb2_timing_end(struct vb2_context *ctx,
+				  enum vb2_timing_phase phase,
+				  uint32_t start_ms, uint32_t bytes)
+{
+	vb2_timing_add(ctx, phase, start_ms, vb2ex_mtime() - start_ms, bytes);
+}
+
+/**
+ * Record an attempt to load a kernel partition, which started at start_ms
+ * and ends now, in the timing record in shared data.
+ *
+ * @param ctx		Vboot context
+ * @param partition	GPT partition number, or 0 for a MiniOS sector
+ * @param start_ms	vb2ex_mtime() when loading started
+ * @param bytes		Number of bytes read from the partition
+ * @param result	Result of loading the partition
+ */
+void vb2_timing_kernel_try(struct vb2_context *ctx, uint32_t partition,
+			   uint32_t start_ms, uint32_t bytes,
+			   vb2_error_t result);
+
 #endif  /* VBOOT_REFERENCE_2MISC_H_ */
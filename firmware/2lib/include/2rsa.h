@@ -61,6 +61,26 @@ vb2_error_t vb2_rsa_verify_digest(const struct vb2_public_key *key,
 				  uint8_t *sig, const uint8_t *digest,
 				  const struct vb2_workbuf *wb);
 
+/**
+ * Verify several RSA PKCS1.5 signatures made with the same key.
+ *
+ * Same as calling vb2_rsa_verify_digest() on each signature, but the key is
+ * checked, the work buffer carved and the Montgomery context set up once.
+ *
+ * @param key		Key to use in signature verification
+ * @param sigs		Signatures to verify (destroyed in process)
+ * @param digests	Digest of signed data, one per signature
+ * @param count		Number of signatures
+ * @param results	Receives the result of verifying each signature
+ * @param wb		Work buffer
+ * @return VB2_SUCCESS if every signature verified, else the first error.
+ */
+vb2_error_t vb2_rsa_verify_digests(const struct vb2_public_key *key,
+				   uint8_t *const sigs[],
+				   const uint8_t *const digests[],
+				   uint32_t count, vb2_error_t results[],
+				   const struct vb2_workbuf *wb);
+
 /**
  * In-place public exponentiation.
  *
@@ -18,4 +18,31 @@ int vb2_mont_ge(const struct vb2_public_key *key, uint32_t *a);
 vb2_error_t vb2_check_padding(const uint8_t *sig,
 			      const struct vb2_public_key *key);
 
+/*
+ * Implementations behind vb2_modexp(): the portable one with 32-bit words,
+ * and one with 64-bit limbs (2modpow64.c) that host builds select when the
+ * compiler has unsigned __int128.  Both produce identical results.
+ */
+void vb2_modexp32(const struct vb2_public_key *key, uint8_t *inout,
+		  void *workbuf, int exp);
+void vb2_modexp64(const struct vb2_public_key *key, uint8_t *inout, int exp);
+
+/*
+ * vb2_modexp64() on several inputs sharing one Montgomery context.  NULL
+ * entries in inouts[] are skipped.
+ */
+void vb2_modexp64_batch(const struct vb2_public_key *key,
+			uint8_t *const inouts[], uint32_t count, int exp);
+
+/*
+ * x86 engines behind vb2ex_hwcrypto_modexp() (2modpow_sse2.c).  The AVX2 one
+ * (2modpow_avx2.c) is used instead of SSE2 when built with VB2_X86_RSA_AVX2
+ * and the CPU supports it.  Both produce identical results.
+ */
+vb2_error_t vb2_modexp_sse2(const struct vb2_public_key *key, uint8_t *inout,
+			    void *workbuf, size_t workbuf_size, int exp);
+vb2_error_t vb2_modexp_avx2(const struct vb2_public_key *key, uint8_t *inout,
+			    void *workbuf, size_t workbuf_size, int exp);
+bool vb2_modexp_avx2_supported(void);
+
 #endif  /* VBOOT_REFERENCE_2RSA_PRIVATE_H_ */
@@ -257,6 +257,28 @@ vb2_error_t vb2_hash_calculate(bool allow_hwcrypto, const void *buf,
 			       uint32_t size, enum vb2_hash_algorithm algo,
 			       struct vb2_hash *hash);
 
+/**
+ * Fill vb2_hash structures with the hashes of several independent buffers.
+ *
+ * This gives the same results as calling vb2_hash_calculate() on each buffer.
+ * Where the CPU allows it (currently SHA-224/SHA-256 with AVX2 on x86_64
+ * hosts, when HW crypto is forbidden), up to 8 buffers are hashed at once in
+ * separate SIMD lanes.
+ *
+ * @param allow_hwcrypto  false to forbid HW crypto by policy; true to allow.
+ * @param bufs		Buffers to hash
+ * @param sizes		Size of each buffer in |bufs| in bytes
+ * @param count		Number of buffers
+ * @param algo		The hash algorithm to use (and store in |hashes|)
+ * @param hashes	|count| vb2_hash structures to fill with the hashes
+ * @return VB2_SUCCESS, or non-zero on error.
+ */
+vb2_error_t vb2_hash_calculate_multi(bool allow_hwcrypto,
+				     const void *const bufs[],
+				     const uint32_t sizes[], uint32_t count,
+				     enum vb2_hash_algorithm algo,
+				     struct vb2_hash hashes[]);
+
 /**
  * Verify that a vb2_hash matches a buffer.
  *
@@ -20,6 +20,7 @@
 extern const uint32_t vb2_sha256_h0[8];
 extern const uint32_t vb2_sha256_k[64];
 extern const uint32_t vb2_hash_seq[8];
+extern const uint64_t vb2_sha512_k[80];
 extern struct vb2_sha256_context vb2_sha_ctx;
 
 #define UNPACK32(x, str)				\
@@ -40,4 +41,44 @@ extern struct vb2_sha256_context vb2_sha_ctx;
 
 void vb2_sha256_transform_hwcrypto(const uint8_t *message,
 				   unsigned int block_nb);
+
+/* Accelerated transforms allowed at runtime (see 2cpu.h) */
+#define VB2_SHA_ACCEL_AVX2 (1 << 0)
+#define VB2_SHA_ACCEL_ARMV8 (1 << 1)
+extern uint32_t vb2_sha_accel_mask;
+
+/*
+ * AVX2 block transforms (2sha_avx2.c).  These expand the message schedules
+ * of several blocks in parallel, so they only pay off for block_nb > 1.
+ * Only call them if vb2_sha_avx2_supported() returns true.
+ */
+bool vb2_sha_avx2_supported(void);
+void vb2_sha256_transform_avx2(uint32_t *state, const uint8_t *message,
+			       unsigned int block_nb);
+void vb2_sha512_transform_avx2(uint64_t *state, const uint8_t *message,
+			       unsigned int block_nb);
+
+/*
+ * Run block_nb blocks of eight independent SHA-256 messages through the
+ * compression function, one message per AVX2 lane.  state[j][i] is word j of
+ * the hash state of lane i, and data[i] points to the blocks of lane i.
+ */
+#define VB2_SHA256_MULTI_LANES 8
+void vb2_sha256_multi_transform_avx2(
+	uint32_t state[8][VB2_SHA256_MULTI_LANES],
+	const uint8_t *const data[VB2_SHA256_MULTI_LANES],
+	unsigned int block_nb);
+
+/*
+ * ARMv8 SHA-1 and SHA-512 instruction block transforms
+ * (sha1_armv8a_ce_a64.S, sha512_armv8a_ce_a64.S).  Only call them if the
+ * matching vb2_sha*_armv8_supported() returns true.
+ */
+bool vb2_sha1_armv8_supported(void);
+bool vb2_sha512_armv8_supported(void);
+void vb2_sha1_transform_armv8(uint32_t *state, const uint8_t *message,
+			      unsigned int block_nb);
+void vb2_sha512_transform_armv8(uint64_t *state, const uint8_t *message,
+				unsigned int block_nb);
+
 #endif  /* VBOOT_REFERENCE_2SHA_PRIVATE_H_ */
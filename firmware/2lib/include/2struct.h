@@ -95,12 +95,101 @@ enum vb2_shared_data_status {
 	VB2_SD_STATUS_RECOVERY_DECIDED = (1 << 7),
 };
 
+/* Boot phases timed in vb2_boot_timing.phase[] */
+enum vb2_timing_phase {
+	/* Reading the GBB header and keys from the GBB */
+	VB2_TIMING_GBB_READ = 0,
+
+	/* Verifying firmware and kernel keyblocks, including their RSA */
+	VB2_TIMING_KEYBLOCK_VERIFY = 1,
+
+	/* Verifying firmware and kernel preambles, including their RSA */
+	VB2_TIMING_PREAMBLE_VERIFY = 2,
+
+	/* Hashing firmware and kernel bodies */
+	VB2_TIMING_BODY_HASH = 3,
+
+	/* RSA verification of firmware and kernel body digests */
+	VB2_TIMING_RSA = 4,
+
+	/* Reading and parsing the GPT */
+	VB2_TIMING_GPT_LOAD = 5,
+
+	/* Number of phases in use; array size is VB2_TIMING_MAX_PHASES */
+	VB2_TIMING_PHASE_COUNT,
+};
+
+/* Sizes of the arrays in vb2_boot_timing; changing these changes its size */
+#define VB2_TIMING_MAX_PHASES 8
+#define VB2_TIMING_MAX_KERNEL_TRIES 8
+
+/*
+ * Times and byte counts for one boot phase.  A phase may run several times
+ * per boot (for example, once for firmware and once per kernel tried), so
+ * the time and bytes are totals.
+ */
+struct vb2_timing_phase_record {
+	/* vb2ex_mtime() at the first start of the phase */
+	uint32_t start_ms;
+
+	/* Total time spent in the phase */
+	uint32_t elapsed_ms;
+
+	/* Number of times the phase ran */
+	uint32_t count;
+
+	/* Total bytes processed */
+	uint32_t bytes;
+} __attribute__((packed));
+
+/* A kernel partition which vboot tried to load */
+struct vb2_timing_kernel_try {
+	/* GPT partition number (starting at 1), or 0 for a MiniOS sector */
+	uint32_t partition;
+
+	/* vb2ex_mtime() when loading started, and time it took */
+	uint32_t start_ms;
+	uint32_t elapsed_ms;
+
+	/* Bytes read from the partition */
+	uint32_t bytes;
+
+	/* Result (vb2_error_t) */
+	uint32_t result;
+} __attribute__((packed));
+
+/*
+ * Boot timing record, exported to the OS in VbSharedDataHeader.  Times are
+ * in milliseconds from vb2ex_mtime(), so phases shorter than that read as 0
+ * unless they run many times.
+ */
+struct vb2_boot_timing {
+	/*
+	 * Number of kernel partitions tried.  Only the first
+	 * VB2_TIMING_MAX_KERNEL_TRIES are recorded in kernel_try[].
+	 */
+	uint32_t kernel_try_count;
+	uint32_t reserved0;
+
+	/* Indexed by enum vb2_timing_phase */
+	struct vb2_timing_phase_record phase[VB2_TIMING_MAX_PHASES];
+
+	struct vb2_timing_kernel_try kernel_try[VB2_TIMING_MAX_KERNEL_TRIES];
+} __attribute__((packed));
+
+_Static_assert(VB2_TIMING_PHASE_COUNT <= VB2_TIMING_MAX_PHASES,
+	       "Too many timing phases");
+
+/* VB2_BOOT_TIMING_SIZE exposed in 2constants.h */
+_Static_assert(VB2_BOOT_TIMING_SIZE == sizeof(struct vb2_boot_timing),
+	       "VB2_BOOT_TIMING_SIZE set incorrectly");
+
 /* "V2SD" = vb2_shared_data.magic */
 #define VB2_SHARED_DATA_MAGIC 0x44533256
 
 /* Current version of vb2_shared_data struct */
 #define VB2_SHARED_DATA_VERSION_MAJOR 3
-#define VB2_SHARED_DATA_VERSION_MINOR 2
+#define VB2_SHARED_DATA_VERSION_MINOR 3
 
 /* MAX_SIZE should not be changed without bumping up DATA_VERSION_MAJOR. */
 #define VB2_CONTEXT_MAX_SIZE 384
@@ -257,6 +346,11 @@ struct vb2_shared_data {
 	 */
 	uint32_t kernel_key_offset;
 	uint32_t kernel_key_size;
+
+	/* Fields added in version 3.3 */
+
+	/* Boot phase timing, exported via vb2api_export_vbsd() */
+	struct vb2_boot_timing timing;
 } __attribute__((packed));
 
 /****************************************************************************/
@@ -104,6 +104,13 @@ typedef struct {
 	/* Outputs */
 	/* Which inputs have been modified?  GPT_MODIFIED_* */
 	uint8_t modified;
+	/*
+	 * Entries [dirty_entries_start, dirty_entries_end) are the only ones
+	 * which changed in the entry arrays marked modified.  If
+	 * dirty_entries_end is 0, any of them may have.
+	 */
+	uint32_t dirty_entries_start;
+	uint32_t dirty_entries_end;
 	/*
 	 * The current chromeos kernel index in partition table.  -1 means not
 	 * found on drive. Note that GPT partition numbers are traditionally
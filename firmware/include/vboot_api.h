@@ -115,10 +115,52 @@ vb2_error_t VbExStreamSkip(VbExStream_t stream, uint32_t bytes);
  */
 vb2_error_t VbExStreamRead(VbExStream_t stream, uint32_t bytes, void *buffer);
 
+/*
+ * Optional asynchronous read extension.
+ *
+ * Implementations which can keep a disk transfer in flight while the caller
+ * works on previously read data (e.g. hashing it) should provide these.  At
+ * most VB2_STREAM_ASYNC_DEPTH reads may be outstanding on a stream at once,
+ * and they complete in the order they were submitted.  Firmware which does
+ * not support asynchronous reads should return VB2_ERROR_EX_UNIMPLEMENTED
+ * from VbExStreamReadAsync(), and callers will fall back to VbExStreamRead().
+ */
+#define VB2_STREAM_ASYNC_DEPTH 2
+
+/**
+ * Submit an asynchronous read from a stream on a disk
+ *
+ * @param stream	Stream to read from
+ * @param bytes		Number of bytes to read
+ * @param buffer	Destination to read into.  Must not be accessed by the
+ *			caller until the read is completed by
+ *			VbExStreamWaitAsync().
+ *
+ * @return Error code, or VB2_SUCCESS.  VB2_ERROR_EX_UNIMPLEMENTED if
+ * asynchronous reads are not supported on this stream.
+ *
+ * The stream position advances by the number of bytes submitted, so a
+ * subsequent read (synchronous or not) continues after this one.
+ */
+vb2_error_t VbExStreamReadAsync(VbExStream_t stream, uint32_t bytes,
+				void *buffer);
+
+/**
+ * Wait for the oldest outstanding asynchronous read on a stream to complete
+ *
+ * @param stream	Stream the read was submitted on
+ *
+ * @return Error code, or VB2_SUCCESS. Failure to read as much data as
+ * requested is an error.
+ */
+vb2_error_t VbExStreamWaitAsync(VbExStream_t stream);
+
 /**
  * Close a stream
  *
  * @param stream	Stream to close
+ *
+ * Any asynchronous reads still outstanding on the stream are abandoned.
  */
 void VbExStreamClose(VbExStream_t stream);
 
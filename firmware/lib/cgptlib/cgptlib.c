@@ -192,7 +192,18 @@ int GptUpdateKernelWithEntry(GptData *gpt, GptEntry *e, uint32_t update_type)
 	}
 
 	if (modified) {
-		GptModified(gpt);
+		GptHeader *header = (GptHeader *)gpt->primary_header;
+		GptEntry *entries = (GptEntry *)gpt->primary_entries;
+		uint32_t index = e - entries;
+
+		/*
+		 * Only this entry changed, so just update its part of the
+		 * CRC if it's in the primary table we can index like this.
+		 */
+		if (e < entries || index >= header->number_of_entries ||
+		    header->size_of_entry != sizeof(GptEntry) ||
+		    GPT_SUCCESS != GptEntriesModified(gpt, index, 1))
+			GptModified(gpt);
 	}
 
 	return GPT_SUCCESS;
@@ -392,11 +392,13 @@ void GptRepair(GptData *gpt)
 		/* Primary is good, secondary is bad */
 		memcpy(entries2, entries1, entries_size);
 		gpt->modified |= GPT_MODIFIED_ENTRIES2;
+		gpt->dirty_entries_end = 0;
 	}
 	else if (MASK_SECONDARY == gpt->valid_entries) {
 		/* Secondary is good, primary is bad */
 		memcpy(entries1, entries2, entries_size);
 		gpt->modified |= GPT_MODIFIED_ENTRIES1;
+		gpt->dirty_entries_end = 0;
 	}
 	gpt->valid_entries = MASK_BOTH;
 }
@@ -496,6 +498,67 @@ void GptModified(GptData *gpt) {
 	GptRepair(gpt);
 }
 
+int GptEntriesModified(GptData *gpt, uint32_t first, uint32_t count)
+{
+	GptHeader *header1 = (GptHeader *)gpt->primary_header;
+	GptHeader *header2 = (GptHeader *)gpt->secondary_header;
+	uint32_t entries_size, crc, start, end, i;
+
+	if (MASK_BOTH != gpt->valid_headers ||
+	    MASK_BOTH != gpt->valid_entries ||
+	    MASK_NONE != gpt->ignored ||
+	    0 != HeaderFieldsSame(header1, header2))
+		return GPT_ERROR_INVALID_ENTRIES;
+
+	if (first > header1->number_of_entries)
+		first = header1->number_of_entries;
+	if (count > header1->number_of_entries - first)
+		count = header1->number_of_entries - first;
+
+	entries_size = header1->size_of_entry * header1->number_of_entries;
+	crc = header1->entries_crc32;
+	start = first + count;
+	end = first;
+
+	for (i = first; i < first + count; i++) {
+		uint32_t offset = i * header1->size_of_entry;
+		uint8_t *e1 = gpt->primary_entries + offset;
+		uint8_t *e2 = gpt->secondary_entries + offset;
+
+		if (!memcmp(e1, e2, header1->size_of_entry))
+			continue;
+
+		crc = Crc32Update(crc, entries_size, offset, e2, e1,
+				  header1->size_of_entry);
+		memcpy(e2, e1, header1->size_of_entry);
+		if (start > i)
+			start = i;
+		end = i + 1;
+	}
+
+	if (start >= end)
+		return GPT_SUCCESS;
+
+	/* Only narrow the dirty range if all previous changes were tracked */
+	if (!(gpt->modified & (GPT_MODIFIED_ENTRIES1 | GPT_MODIFIED_ENTRIES2))) {
+		gpt->dirty_entries_start = start;
+		gpt->dirty_entries_end = end;
+	} else if (gpt->dirty_entries_end) {
+		if (gpt->dirty_entries_start > start)
+			gpt->dirty_entries_start = start;
+		if (gpt->dirty_entries_end < end)
+			gpt->dirty_entries_end = end;
+	}
+
+	header1->entries_crc32 = crc;
+	header1->header_crc32 = HeaderCrc(header1);
+	header2->entries_crc32 = crc;
+	header2->header_crc32 = HeaderCrc(header2);
+	gpt->modified |= GPT_MODIFIED_HEADER1 | GPT_MODIFIED_ENTRIES1 |
+		GPT_MODIFIED_HEADER2 | GPT_MODIFIED_ENTRIES2;
+
+	return GPT_SUCCESS;
+}
 
 const char *GptErrorText(int error_code)
 {
@@ -0,0 +1,34 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * CRC32 using the ARMv8 CRC32 instructions, which compute the same
+ * bit-reflected polynomial as Crc32().  They are optional in ARMv8.0, so are
+ * probed at runtime.
+ */
+
+#include <arm_acle.h>
+
+#include "2cpu.h"
+#include "2sysincludes.h"
+#include "crc32_private.h"
+
+uint32_t Crc32Armv8(uint32_t crc, const uint8_t *buf, uint32_t len)
+{
+	uint64_t data;
+
+	for (; len >= 8; buf += 8, len -= 8) {
+		memcpy(&data, buf, sizeof(data));
+		crc = __crc32d(crc, data);
+	}
+	for (; len; buf++, len--)
+		crc = __crc32b(crc, *buf);
+
+	return crc;
+}
+
+bool Crc32Armv8Supported(void)
+{
+	return (crc32_accel_mask & CRC32_ACCEL_ARMV8) &&
+		vb2_cpu_has(VB2_CPU_ARM_CRC32);
+}
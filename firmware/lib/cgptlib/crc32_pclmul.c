@@ -0,0 +1,103 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * CRC32 using x86 carry-less multiplication (PCLMULQDQ), following Intel's
+ * "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction".
+ * Four 128-bit lanes are folded 64 bytes at a time, then folded together and
+ * Barrett reduced to the 32-bit CRC.
+ */
+
+#include <emmintrin.h>
+#include <wmmintrin.h>
+
+#include "2cpu.h"
+#include "2sysincludes.h"
+#include "crc32_private.h"
+
+/*
+ * Folding constants for the bit-reflected CRC32 polynomial 0x104c11db7:
+ * x^(4*128+32) and x^(4*128-32) mod P, then the same for a 128-bit fold,
+ * x^64 mod P, and finally P' and mu for the Barrett reduction.
+ */
+static const uint64_t k1k2[2] __attribute__((aligned(16))) = {
+	0x0154442bd4, 0x01c6e41596,
+};
+static const uint64_t k3k4[2] __attribute__((aligned(16))) = {
+	0x01751997d0, 0x00ccaa009e,
+};
+static const uint64_t k5k0[2] __attribute__((aligned(16))) = {
+	0x0163cd6124, 0x0000000000,
+};
+static const uint64_t poly[2] __attribute__((aligned(16))) = {
+	0x01db710641, 0x01f7011641,
+};
+
+/* Fold 128 bits of x forward by the distance in k, and add in data. */
+static inline __m128i fold(__m128i x, __m128i k, __m128i data)
+{
+	__m128i lo = _mm_clmulepi64_si128(x, k, 0x00);
+	__m128i hi = _mm_clmulepi64_si128(x, k, 0x11);
+
+	return _mm_xor_si128(_mm_xor_si128(hi, lo), data);
+}
+
+uint32_t Crc32Pclmul(uint32_t crc, const uint8_t *buf, uint32_t len)
+{
+	__m128i x0, x1, x2, x3, x4, mask;
+
+	x1 = _mm_loadu_si128((const __m128i *)(buf + 0x00));
+	x2 = _mm_loadu_si128((const __m128i *)(buf + 0x10));
+	x3 = _mm_loadu_si128((const __m128i *)(buf + 0x20));
+	x4 = _mm_loadu_si128((const __m128i *)(buf + 0x30));
+	x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(crc));
+	buf += 64;
+	len -= 64;
+
+	/* Fold 64 bytes at a time, in four independent lanes */
+	x0 = _mm_load_si128((const __m128i *)k1k2);
+	for (; len >= 64; buf += 64, len -= 64) {
+		x1 = fold(x1, x0, _mm_loadu_si128((const __m128i *)buf));
+		x2 = fold(x2, x0,
+			  _mm_loadu_si128((const __m128i *)(buf + 0x10)));
+		x3 = fold(x3, x0,
+			  _mm_loadu_si128((const __m128i *)(buf + 0x20)));
+		x4 = fold(x4, x0,
+			  _mm_loadu_si128((const __m128i *)(buf + 0x30)));
+	}
+
+	/* Fold the lanes together, then any remaining 16-byte blocks */
+	x0 = _mm_load_si128((const __m128i *)k3k4);
+	x1 = fold(x1, x0, x2);
+	x1 = fold(x1, x0, x3);
+	x1 = fold(x1, x0, x4);
+	for (; len >= 16; buf += 16, len -= 16)
+		x1 = fold(x1, x0, _mm_loadu_si128((const __m128i *)buf));
+
+	/* Fold 128 bits down to 64 */
+	x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+	mask = _mm_setr_epi32(~0, 0, ~0, 0);
+	x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+
+	x0 = _mm_loadl_epi64((const __m128i *)k5k0);
+	x2 = _mm_srli_si128(x1, 4);
+	x1 = _mm_and_si128(x1, mask);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+
+	/* Barrett reduction to 32 bits */
+	x0 = _mm_load_si128((const __m128i *)poly);
+	x2 = _mm_and_si128(x1, mask);
+	x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+	x2 = _mm_and_si128(x2, mask);
+	x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+
+	return _mm_cvtsi128_si32(_mm_srli_si128(x1, 4));
+}
+
+bool Crc32PclmulSupported(void)
+{
+	return (crc32_accel_mask & CRC32_ACCEL_PCLMUL) &&
+		vb2_cpu_has(VB2_CPU_X86_PCLMUL);
+}
@@ -161,6 +161,19 @@ int GptValidityCheck(GptData *gpt);
  */
 void GptRepair(GptData *gpt);
 
+/**
+ * Bring the secondary entries and both headers up to date after primary
+ * entries in [first, first + count) have been changed, and no others.  Only
+ * entries which differ from their secondary copy are folded into the entries
+ * CRC, copied and added to the dirty range.
+ *
+ * The secondary entries must still hold the old contents, so this needs both
+ * GPTs to be valid and identical beforehand.  If they aren't, nothing is
+ * changed and GPT_ERROR_INVALID_ENTRIES is returned; use GptModified()
+ * instead.
+ */
+int GptEntriesModified(GptData *gpt, uint32_t first, uint32_t count);
+
 /**
  * Return a pointer to text describing the passed in error.
  */
@@ -10,4 +10,12 @@
 
 uint32_t Crc32(const void *buffer, uint32_t len);
 
+/*
+ * Return the CRC32 of a 'len'-byte buffer whose CRC32 was 'crc', after the
+ * 'size' bytes at 'offset' changed from 'old_data' to 'new_data'.  Takes time
+ * proportional to 'size' and log('len'), rather than to 'len'.
+ */
+uint32_t Crc32Update(uint32_t crc, uint32_t len, uint32_t offset,
+		     const void *old_data, const void *new_data, uint32_t size);
+
 #endif  /* VBOOT_REFERENCE_CRC32_H_ */
@@ -0,0 +1,42 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * CRC32 implementations behind Crc32(), exposed for tests and benchmarks.
+ */
+
+#ifndef VBOOT_REFERENCE_CRC32_PRIVATE_H_
+#define VBOOT_REFERENCE_CRC32_PRIVATE_H_
+
+#include "2sysincludes.h"
+
+/*
+ * Each implementation takes and returns the raw CRC register, so callers
+ * start with ~0U and invert the final value, as Crc32() does.  All produce
+ * identical results.
+ */
+
+/* The reference implementation, one table lookup per byte */
+uint32_t Crc32Bytewise(uint32_t crc, const uint8_t *buf, uint32_t len);
+
+/* Portable slice-by-8, folding in eight bytes per iteration */
+uint32_t Crc32Slice8(uint32_t crc, const uint8_t *buf, uint32_t len);
+
+/*
+ * Carry-less multiplication folding with x86 PCLMULQDQ (crc32_pclmul.c).  len
+ * must be a multiple of 16 and at least CRC32_PCLMUL_MIN_LEN.
+ */
+#define CRC32_PCLMUL_MIN_LEN 64
+uint32_t Crc32Pclmul(uint32_t crc, const uint8_t *buf, uint32_t len);
+bool Crc32PclmulSupported(void);
+
+/* ARMv8 CRC32 instructions (crc32_armv8.c) */
+uint32_t Crc32Armv8(uint32_t crc, const uint8_t *buf, uint32_t len);
+bool Crc32Armv8Supported(void);
+
+/* Accelerated implementations allowed at runtime (see 2cpu.h) */
+#define CRC32_ACCEL_PCLMUL (1 << 0)
+#define CRC32_ACCEL_ARMV8 (1 << 1)
+extern uint32_t crc32_accel_mask;
+
+#endif  /* VBOOT_REFERENCE_CRC32_PRIVATE_H_ */
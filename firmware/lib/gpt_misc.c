@@ -26,6 +26,7 @@ int AllocAndReadGptData(vb2ex_disk_handle_t disk_handle, GptData *gptdata)
 
 	/* No data to be written yet */
 	gptdata->modified = 0;
+	gptdata->dirty_entries_end = 0;
 	/* This should get overwritten by GptInit() */
 	gptdata->ignored = 0;
 
@@ -152,6 +153,7 @@ int WriteAndFreeGptData(vb2ex_disk_handle_t disk_handle, GptData *gptdata)
 	int skip_primary = 0;
 	GptHeader *header;
 	uint64_t entries_bytes, entries_sectors;
+	uint64_t dirty_first = 0, dirty_sectors;
 	int ret = 1;
 
 	header = (GptHeader *)gptdata->primary_header;
@@ -164,6 +166,26 @@ int WriteAndFreeGptData(vb2ex_disk_handle_t disk_handle, GptData *gptdata)
 			* header->size_of_entry;
 	entries_sectors = entries_bytes / gptdata->sector_bytes;
 
+	/*
+	 * If only some entries changed, only write the sectors holding them.
+	 * Typically that's one sector per copy, rather than the whole table.
+	 */
+	dirty_sectors = entries_sectors;
+	if (gptdata->dirty_entries_end) {
+		uint64_t start = (uint64_t)gptdata->dirty_entries_start *
+			header->size_of_entry;
+		uint64_t end = (uint64_t)gptdata->dirty_entries_end *
+			header->size_of_entry;
+
+		dirty_first = start / gptdata->sector_bytes;
+		dirty_sectors = (end + gptdata->sector_bytes - 1) /
+			gptdata->sector_bytes;
+		if (dirty_sectors > entries_sectors)
+			dirty_sectors = entries_sectors;
+		dirty_sectors = dirty_first < dirty_sectors ?
+			dirty_sectors - dirty_first : 0;
+	}
+
 	/*
 	 * TODO(namnguyen): Preserve padding between primary GPT header and
 	 * its entries.
@@ -195,9 +217,12 @@ int WriteAndFreeGptData(vb2ex_disk_handle_t disk_handle, GptData *gptdata)
 	if (gptdata->primary_entries && !skip_primary) {
 		if (gptdata->modified & GPT_MODIFIED_ENTRIES1) {
 			VB2_DEBUG("Updating GPT entries 1\n");
-			if (0 != VbExDiskWrite(disk_handle, entries_lba,
-					       entries_sectors,
-					       gptdata->primary_entries))
+			if (0 != VbExDiskWrite(disk_handle,
+					       entries_lba + dirty_first,
+					       dirty_sectors,
+					       gptdata->primary_entries +
+					       dirty_first *
+					       gptdata->sector_bytes))
 				goto fail;
 		}
 	}
@@ -220,8 +245,11 @@ int WriteAndFreeGptData(vb2ex_disk_handle_t disk_handle, GptData *gptdata)
 		if (gptdata->modified & GPT_MODIFIED_ENTRIES2) {
 			VB2_DEBUG("Updating GPT entries 2\n");
 			if (0 != VbExDiskWrite(disk_handle,
-					       entries_lba, entries_sectors,
-					       gptdata->secondary_entries))
+					       entries_lba + dirty_first,
+					       dirty_sectors,
+					       gptdata->secondary_entries +
+					       dirty_first *
+					       gptdata->sector_bytes))
 				goto fail;
 		}
 	}
@@ -10,6 +10,7 @@
 
 #include <stdint.h>
 
+#include "2constants.h"
 #include "2sysincludes.h"
 
 #ifdef __cplusplus
@@ -22,7 +23,7 @@ extern "C" {
 #define VB_SHARED_DATA_MAGIC 0x44536256
 
 /* Version for struct_version */
-#define VB_SHARED_DATA_VERSION 3
+#define VB_SHARED_DATA_VERSION 4
 
 /*
  * Flags for VbSharedDataHeader
@@ -110,8 +111,15 @@ typedef struct VbSharedDataHeader {
 	/* Firmware lowest version found */
 	uint32_t fw_version_lowest;
 
+	/*
+	 * Boot timing record (struct vb2_boot_timing).  Added in version 4,
+	 * in what used to be padding, so make sure that struct_version >= 4
+	 * before accessing.
+	 */
+	uint8_t boot_timing[VB2_BOOT_TIMING_SIZE];
+
 	/* Reserved for padding */
-	uint8_t reserved3[916];
+	uint8_t reserved3[916 - VB2_BOOT_TIMING_SIZE];
 
 	/*
 	 * Fields added in version 2.  Before accessing, make sure that
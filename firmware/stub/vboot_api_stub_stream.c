@@ -13,6 +13,18 @@
 /* The stub implementation assumes 512-byte disk sectors */
 #define LBA_BYTES 512
 
+/* Asynchronous read submitted but not yet completed */
+struct disk_stream_request {
+	/* First sector to read */
+	uint64_t sector;
+
+	/* Number of sectors to read */
+	uint64_t count;
+
+	/* Destination buffer */
+	void *buffer;
+};
+
 /* Internal struct to simulate a stream for sector-based disks */
 struct disk_stream {
 	/* Disk handle */
@@ -23,6 +35,10 @@ struct disk_stream {
 
 	/* Number of sectors left in partition */
 	uint64_t sectors_left;
+
+	/* Outstanding asynchronous reads, oldest first */
+	struct disk_stream_request pending[VB2_STREAM_ASYNC_DEPTH];
+	uint32_t pending_count;
 };
 
 __attribute__((weak))
@@ -42,6 +58,7 @@ vb2_error_t VbExStreamOpen(vb2ex_disk_handle_t handle, uint64_t lba_start,
 	s->handle = handle;
 	s->sector = lba_start;
 	s->sectors_left = lba_count;
+	s->pending_count = 0;
 
 	*stream = (void *)s;
 
@@ -84,6 +101,64 @@ vb2_error_t VbExStreamRead(VbExStream_t stream, uint32_t bytes, void *buffer)
 	return VB2_SUCCESS;
 }
 
+/*
+ * The stub has no disk controller to run transfers in the background, so a
+ * submitted read is only recorded and the stream position advanced.  The
+ * actual VbExDiskRead() happens when the caller waits for it, which keeps the
+ * ordering and buffer-ownership rules identical to a real implementation.
+ */
+__attribute__((weak))
+vb2_error_t VbExStreamReadAsync(VbExStream_t stream, uint32_t bytes,
+				void *buffer)
+{
+	struct disk_stream *s = (struct disk_stream *)stream;
+	struct disk_stream_request *req;
+	uint64_t sectors;
+
+	if (!s || !buffer)
+		return VB2_ERROR_UNKNOWN;
+
+	if (s->pending_count >= VB2_STREAM_ASYNC_DEPTH)
+		return VB2_ERROR_UNKNOWN;
+
+	/* For now, require reads to be a multiple of the LBA size */
+	if (bytes % LBA_BYTES)
+		return VB2_ERROR_UNKNOWN;
+
+	/* Fail on overflow */
+	sectors = bytes / LBA_BYTES;
+	if (sectors > s->sectors_left)
+		return VB2_ERROR_UNKNOWN;
+
+	req = &s->pending[s->pending_count++];
+	req->sector = s->sector;
+	req->count = sectors;
+	req->buffer = buffer;
+
+	s->sector += sectors;
+	s->sectors_left -= sectors;
+
+	return VB2_SUCCESS;
+}
+
+__attribute__((weak))
+vb2_error_t VbExStreamWaitAsync(VbExStream_t stream)
+{
+	struct disk_stream *s = (struct disk_stream *)stream;
+	struct disk_stream_request req;
+	uint32_t i;
+
+	if (!s || !s->pending_count)
+		return VB2_ERROR_UNKNOWN;
+
+	req = s->pending[0];
+	for (i = 1; i < s->pending_count; i++)
+		s->pending[i - 1] = s->pending[i];
+	s->pending_count--;
+
+	return VbExDiskRead(s->handle, req.sector, req.count, req.buffer);
+}
+
 __attribute__((weak))
 void VbExStreamClose(VbExStream_t stream)
 {
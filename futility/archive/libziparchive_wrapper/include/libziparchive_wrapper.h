@@ -111,6 +111,27 @@ int libziparchive_extract_entry(struct libziparchive_handle *handle,
 				struct libziparchive_entry *entry, uint8_t **data,
 				size_t *size);
 
+/*
+ * Returns uncompressed size of the entry.
+ */
+size_t libziparchive_get_size(struct libziparchive_entry *entry);
+
+/*
+ * Locates the data of an entry stored without compression. `fd` is set to the opened archive
+ * file, and `offset` to where the data starts in it. The file descriptor is owned by `handle`.
+ * Returns zero on success, non-zero if the entry is compressed.
+ */
+int libziparchive_get_stored_data(struct libziparchive_handle *handle,
+				  struct libziparchive_entry *entry, int *fd, uint64_t *offset);
+
+/*
+ * Extracts contents of the entry into `data`, which must hold `size` bytes, the uncompressed
+ * size of the entry. Returns zero on success.
+ */
+int libziparchive_extract_entry_to(struct libziparchive_handle *handle,
+				   struct libziparchive_entry *entry, uint8_t *data,
+				   size_t size);
+
 /*
  * Writes a new entry in the archive. Returns zero on success.
  */
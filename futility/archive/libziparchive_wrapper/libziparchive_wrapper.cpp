@@ -165,6 +165,39 @@ int libziparchive_extract_entry(struct libziparchive_handle *handle,
 	return ExtractToMemory(reader, target, *data, *size);
 }
 
+size_t libziparchive_get_size(struct libziparchive_entry *entry)
+{
+	return ((ZipEntry64 *)entry)->uncompressed_length;
+}
+
+int libziparchive_get_stored_data(struct libziparchive_handle *handle,
+				  struct libziparchive_entry *entry, int *fd, uint64_t *offset)
+{
+	int r = open_reader(handle);
+	if (r)
+		return r;
+
+	auto target = (ZipEntry64 *)entry;
+	if (target->method != kCompressStored)
+		return LIBZIPARCHIVE_WRAPPER_FAILURE;
+
+	*fd = GetFileDescriptor((ZipArchiveHandle)handle->reader);
+	*offset = target->offset;
+	return *fd < 0 ? LIBZIPARCHIVE_WRAPPER_FAILURE : 0;
+}
+
+int libziparchive_extract_entry_to(struct libziparchive_handle *handle,
+				   struct libziparchive_entry *entry, uint8_t *data,
+				   size_t size)
+{
+	int r = open_reader(handle);
+	if (r)
+		return r;
+
+	return ExtractToMemory((ZipArchiveHandle)handle->reader, (ZipEntry64 *)entry, data,
+			       size);
+}
+
 int libziparchive_write_entry(struct libziparchive_handle *handle, const char *name,
 			      uint8_t *data, size_t size, int32_t mtime)
 {
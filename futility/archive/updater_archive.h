@@ -6,6 +6,7 @@
 #ifndef VBOOT_REFERENCE_FUTILITY_ARCHIVE_UPDATER_ARCHIVE_H_
 #define VBOOT_REFERENCE_FUTILITY_ARCHIVE_UPDATER_ARCHIVE_H_
 
+#include <pthread.h>
 #include <stdint.h>
 
 /*
@@ -15,6 +16,8 @@
  */
 struct u_archive {
 	void *handle;
+	/* Serializes calls into the driver, see updater_archive.c. */
+	pthread_mutex_t lock;
 
 	void * (*open)(const char *name);
 	int (*close)(void *handle);
@@ -26,8 +29,27 @@ struct u_archive {
 			 uint8_t **data, uint32_t *size, int64_t *mtime);
 	int (*write_file)(void *handle, const char *fname,
 			  uint8_t *data, uint32_t size, int64_t mtime);
+	int (*map_file)(void *handle, const char *fname,
+			uint8_t **data, uint32_t *size, int64_t *mtime);
+	void (*release_file)(void *handle, uint8_t *data, uint32_t size);
 };
 
+/*
+ * Helpers for the map_file and release_file callbacks.  Views are always
+ * private memory mappings, either of the file holding the data or of
+ * anonymous memory to decompress into, so every driver releases them with
+ * archive_view_release.
+ */
+
+/* Allocates a view of size bytes to fill in.  Returns NULL on failure. */
+uint8_t *archive_view_alloc(uint32_t size);
+
+/* Maps size bytes at offset in file fd as a view.  Returns NULL on failure. */
+uint8_t *archive_view_map(int fd, uint64_t offset, uint32_t size);
+
+/* Releases a view from archive_view_alloc or archive_view_map. */
+void archive_view_release(void *handle, uint8_t *data, uint32_t size);
+
 #if defined(HAVE_LIBZIP)
 extern struct u_archive archive_zip;
 #endif
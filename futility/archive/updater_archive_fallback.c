@@ -5,6 +5,7 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <fts.h>
 #include <stddef.h>
 #include <stdlib.h>
@@ -123,6 +124,52 @@ static int archive_fallback_read_file(void *handle, const char *fname,
 	return r;
 }
 
+/* Callback for archive_map_file on a general file system. */
+static int archive_fallback_map_file(void *handle, const char *fname,
+				     uint8_t **data, uint32_t *size, int64_t *mtime)
+{
+	char *temp_path = NULL;
+	const char *path = archive_fallback_get_path(handle, fname, &temp_path);
+	struct stat st;
+	int fd;
+
+	VB2_DEBUG("Mapping %s\n", path);
+	*data = NULL;
+	*size = 0;
+	fd = open(path, O_RDONLY);
+	if (fd >= 0 && fstat(fd, &st) == 0 && S_ISREG(st.st_mode) &&
+	    st.st_size <= UINT32_MAX) {
+		*data = archive_view_map(fd, 0, st.st_size);
+		if (*data) {
+			*size = st.st_size;
+			if (mtime)
+				*mtime = st.st_mtime;
+		}
+	}
+	if (fd >= 0)
+		close(fd);
+
+	/* Pipes and other files which can't be mapped are read in. */
+	if (!*data) {
+		uint8_t *buf;
+		uint32_t len;
+
+		if (archive_fallback_read_file(handle, fname, &buf, &len, mtime)) {
+			free(temp_path);
+			return 1;
+		}
+		*data = archive_view_alloc(len);
+		if (*data) {
+			memcpy(*data, buf, len);
+			*size = len;
+		}
+		free(buf);
+	}
+
+	free(temp_path);
+	return *data == NULL;
+}
+
 /* Callback for archive_write_file on a general file system. */
 static int archive_fallback_write_file(void *handle, const char *fname,
 				       uint8_t *data, uint32_t size, int64_t mtime)
@@ -164,4 +211,6 @@ struct u_archive archive_fallback = {
 	.has_entry = archive_fallback_has_entry,
 	.read_file = archive_fallback_read_file,
 	.write_file = archive_fallback_write_file,
+	.map_file = archive_fallback_map_file,
+	.release_file = archive_view_release,
 };
@@ -19,181 +19,271 @@
 #endif
 
 /*
- * -- The cache driver (used by other drivers). --
+ * -- The index (used by the libarchive driver). --
  */
 
 /*
- * For stream-based archives (e.g., tar+gz) we want to create a cache for
- * storing the names and contents for later processing.
+ * libarchive can only read entries in order, and for stream-based archives
+ * (e.g., tar+gz) only by decompressing everything before them.  So we scan
+ * the headers once when opening the archive, remember where each regular
+ * file is, and only decompress the entries that are actually read.
  */
-struct archive_cache {
+struct archive_index_entry {
 	char *name;
-	uint8_t *data;
+	int64_t position;	/* Ordinal of the header in the archive */
 	int64_t mtime;
 	size_t size;
-	int has_data;
-	struct archive_cache *next;
+	uint32_t hash_next;	/* Next entry in the bucket, plus one */
 };
 
-/* Add a new cache node to an existing cache list and return the new head. */
-static struct archive_cache *archive_cache_new(struct archive_cache *cache,
-					       const char *name)
+struct archive_index {
+	char *path;
+	struct archive_index_entry *entries;
+	uint32_t num_entries;
+	uint32_t *buckets;	/* First entry in each bucket, plus one */
+	uint32_t num_buckets;	/* Always a power of two */
+
+	/* A reader which will return header 'next_position' next, or NULL */
+	struct archive *reader;
+	int64_t next_position;
+};
+
+/* FNV-1a, which is plenty for a few hundred file names. */
+static uint32_t archive_index_hash(const char *name)
+{
+	uint32_t hash = 2166136261U;
+
+	for (; *name; name++)
+		hash = (hash ^ (uint8_t)*name) * 16777619U;
+	return hash;
+}
+
+/* Add an entry to the index, which must not be hashed yet. */
+static struct archive_index_entry *archive_index_add(
+		struct archive_index *index, const char *name)
 {
-	struct archive_cache *c;
+	struct archive_index_entry *entries, *e;
 
-	c = (struct archive_cache *)calloc(sizeof(*c), 1);
-	if (!c)
+	entries = (struct archive_index_entry *)realloc(
+			index->entries,
+			(index->num_entries + 1) * sizeof(*entries));
+	if (!entries)
 		return NULL;
+	index->entries = entries;
 
-	c->name = strdup(name);
-	if (!c->name) {
-		free(c);
+	e = &entries[index->num_entries];
+	memset(e, 0, sizeof(*e));
+	e->name = strdup(name);
+	if (!e->name)
 		return NULL;
-	}
 
-	c->next = cache;
-	return c;
+	index->num_entries++;
+	return e;
 }
 
-/* Find and return an entry (by name) from the cache. */
-static struct archive_cache *archive_cache_find(struct archive_cache *c,
-						const char *name)
+/* Build the hash table once all entries have been added. */
+static int archive_index_build(struct archive_index *index)
 {
-	for (; c; c = c->next) {
-		assert(c->name);
-		if (!strcmp(c->name, name))
-			return c;
-	}
-	return NULL;
-}
+	uint32_t i;
 
-/* Callback for archive_walk to process all entries in the cache. */
-static int archive_cache_walk(
-		struct archive_cache *c, void *arg,
-		int (*callback)(const char *name, void *arg))
-{
-	for (; c; c = c->next) {
-		assert(c->name);
-		if (callback(c->name, arg))
-			break;
+	index->num_buckets = 16;
+	while (index->num_buckets < 2 * index->num_entries)
+		index->num_buckets *= 2;
+
+	index->buckets = (uint32_t *)calloc(index->num_buckets,
+					    sizeof(*index->buckets));
+	if (!index->buckets)
+		return -1;
+
+	/*
+	 * Later entries go in front of earlier ones, so the last of any
+	 * duplicate names is found, as when a file is appended to a tar.
+	 */
+	for (i = 1; i <= index->num_entries; i++) {
+		struct archive_index_entry *e = &index->entries[i - 1];
+		uint32_t b = archive_index_hash(e->name) &
+			(index->num_buckets - 1);
+
+		e->hash_next = index->buckets[b];
+		index->buckets[b] = i;
 	}
 	return 0;
 }
 
-/* Delete all entries in the cache. */
-static void *archive_cache_free(struct archive_cache *c)
+/* Find and return an entry (by name) from the index. */
+static struct archive_index_entry *archive_index_find(
+		struct archive_index *index, const char *name)
 {
-	struct archive_cache *next;
+	uint32_t i;
 
-	while (c) {
-		next = c->next;
-		free(c->name);
-		free(c->data);
-		free(c);
-		c = next;
+	if (!index->buckets)
+		return NULL;
+
+	i = index->buckets[archive_index_hash(name) &
+			   (index->num_buckets - 1)];
+	for (; i; i = index->entries[i - 1].hash_next) {
+		assert(index->entries[i - 1].name);
+		if (!strcmp(index->entries[i - 1].name, name))
+			return &index->entries[i - 1];
 	}
 	return NULL;
 }
 
+/* Delete the index and close its reader. */
+static void archive_index_free(struct archive_index *index)
+{
+	uint32_t i;
+
+	if (!index)
+		return;
+	if (index->reader)
+		archive_read_free(index->reader);
+	for (i = 0; i < index->num_entries; i++)
+		free(index->entries[i].name);
+	free(index->entries);
+	free(index->buckets);
+	free(index->path);
+	free(index);
+}
+
 /*
  * -- The libarchive driver (multiple formats but very slow). --
  */
 
-enum {
-	FILTER_IGNORE,
-	FILTER_ABORT,
-	FILTER_NAME_ONLY,
-	FILTER_READ_ALL,
-};
-
-static struct archive_cache *libarchive_read_file_entries(
-		const char *fpath, int (*filter)(struct archive_entry *entry))
+/* Open a new reader on the archive, positioned before the first header. */
+static struct archive *libarchive_open_reader(const char *fpath)
 {
 	struct archive *a = archive_read_new();
-	struct archive_entry *entry;
-	struct archive_cache *c, *cache = NULL;
-	int r;
 
 	assert(a);
 	archive_read_support_filter_all(a);
 	archive_read_support_format_all(a);
-	r = archive_read_open_filename(a, fpath, 10240);
-	if (r != ARCHIVE_OK) {
-		ERROR("Failed parsing archive using libarchive: %s\n", fpath);
+	if (archive_read_open_filename(a, fpath, 10240) != ARCHIVE_OK) {
 		archive_read_free(a);
 		return NULL;
 	}
+	return a;
+}
 
-	WARN("Loading data from archive: %s ", fpath);
-	while (archive_read_next_header(a, &entry) == ARCHIVE_OK) {
-		fputc('.', stderr);
-		if (archive_entry_filetype(entry) != AE_IFREG)
-			continue;
-		if (filter)
-			r = filter(entry);
-		else
-			r = FILTER_READ_ALL;
+/* Scan all the headers in the archive (without reading data) into an index. */
+static struct archive_index *libarchive_read_index(const char *fpath)
+{
+	struct archive_index *index;
+	struct archive_entry *entry;
+	struct archive *a;
+	int64_t position;
 
-		if (r == FILTER_ABORT)
-			break;
-		if (r == FILTER_IGNORE)
+	a = libarchive_open_reader(fpath);
+	if (!a) {
+		ERROR("Failed parsing archive using libarchive: %s\n", fpath);
+		return NULL;
+	}
+
+	index = (struct archive_index *)calloc(1, sizeof(*index));
+	if (!index || !(index->path = strdup(fpath))) {
+		ERROR("Internal error: out of memory.\n");
+		goto fail;
+	}
+
+	/* Moving to the next header skips the data of the current one. */
+	for (position = 0; archive_read_next_header(a, &entry) == ARCHIVE_OK;
+	     position++) {
+		struct archive_index_entry *e;
+
+		if (archive_entry_filetype(entry) != AE_IFREG)
 			continue;
 
-		c = archive_cache_new(cache, archive_entry_pathname(entry));
-		if (!c) {
+		e = archive_index_add(index, archive_entry_pathname(entry));
+		if (!e) {
 			ERROR("Internal error: out of memory.\n");
-			archive_cache_free(cache);
-			archive_read_free(a);
-			return NULL;
+			goto fail;
 		}
-		cache = c;
+		e->position = position;
+		e->size = archive_entry_size(entry);
+		e->mtime = archive_entry_mtime(entry);
+	}
+	archive_read_free(a);
+	a = NULL;
 
-		if (r == FILTER_NAME_ONLY)
-			continue;
+	/* Not an archive libarchive understands, or nothing useful in it. */
+	if (!index->num_entries)
+		goto fail;
 
-		assert(r == FILTER_READ_ALL);
-		c->size = archive_entry_size(entry);
-		c->mtime = archive_entry_mtime(entry);
-		c->data = (uint8_t *)calloc(1, c->size + 1);
-		if (!c->data) {
-			WARN("Out of memory when loading: %s\n", c->name);
-			continue;
+	if (archive_index_build(index)) {
+		ERROR("Internal error: out of memory.\n");
+		goto fail;
+	}
+
+	VB2_DEBUG("Indexed %u files in archive: %s.\n",
+		  index->num_entries, fpath);
+	return index;
+
+fail:
+	if (a)
+		archive_read_free(a);
+	archive_index_free(index);
+	return NULL;
+}
+
+/*
+ * Move the reader of the index to the header of 'e' and read it.  Entries
+ * after the last one read are reached by skipping forward; anything earlier
+ * needs the archive to be opened again.
+ */
+static int libarchive_seek(struct archive_index *index,
+			   const struct archive_index_entry *e)
+{
+	struct archive_entry *entry = NULL;
+
+	if (index->reader && index->next_position > e->position) {
+		archive_read_free(index->reader);
+		index->reader = NULL;
+	}
+	if (!index->reader) {
+		index->reader = libarchive_open_reader(index->path);
+		if (!index->reader) {
+			ERROR("Failed reopening archive: %s\n", index->path);
+			return -1;
 		}
-		if (archive_read_data(a, c->data, c->size) != c->size) {
-			WARN("Failed reading from archive: %s\n", c->name);
-			continue;
+		index->next_position = 0;
+	}
+
+	while (index->next_position <= e->position) {
+		if (archive_read_next_header(index->reader, &entry) !=
+		    ARCHIVE_OK) {
+			ERROR("Failed seeking to %s in archive: %s\n",
+			      e->name, index->path);
+			archive_read_free(index->reader);
+			index->reader = NULL;
+			return -1;
 		}
-		c->has_data = 1;
+		index->next_position++;
 	}
-	fputs("\r\n", stderr);  /* Flush the '.' */
-	VB2_DEBUG("Finished loading from archive: %s.\n", fpath);
 
-	archive_read_free(a);
-	return cache;
+	if (strcmp(archive_entry_pathname(entry), e->name)) {
+		ERROR("Archive changed while reading: %s\n", index->path);
+		return -1;
+	}
+	return 0;
 }
 
 /* Callback for archive_open on an ARCHIVE file. */
 static void *archive_libarchive_open(const char *name)
 {
-	/*
-	 * The firmware archives today can usually all load into memory
-	 * so we are using a NULL filter. Change that to a specific list in
-	 * future if the /build/$BOARD/firmware archive becomes too large.
-	 */
-	return libarchive_read_file_entries(name, NULL);
+	return libarchive_read_index(name);
 }
 
 /* Callback for archive_close on an ARCHIVE file. */
 static int archive_libarchive_close(void *handle)
 {
-	archive_cache_free(handle);
+	archive_index_free(handle);
 	return 0;
 }
 
 /* Callback for archive_has_entry on an ARCHIVE file. */
 static int archive_libarchive_has_entry(void *handle, const char *fname)
 {
-	return archive_cache_find(handle, fname) != NULL;
+	return archive_index_find(handle, fname) != NULL;
 }
 
 /* Callback for archive_walk on an ARCHIVE file. */
@@ -201,39 +291,84 @@ static int archive_libarchive_walk(
 		void *handle, void *arg,
 		int (*callback)(const char *name, void *arg))
 {
-	return archive_cache_walk(handle, arg, callback);
+	struct archive_index *index = handle;
+	uint32_t i;
+
+	for (i = 0; i < index->num_entries; i++) {
+		if (callback(index->entries[i].name, arg))
+			break;
+	}
+	return 0;
 }
 
-/* Callback for archive_read_file on an ARCHIVE file. */
-static int archive_libarchive_read_file(
-		void *handle, const char *fname, uint8_t **data,
-		uint32_t *size, int64_t *mtime)
+/*
+ * Decompresses the entry fname into a new buffer, or a view if map is set.
+ * Returns 0 on success, otherwise non-zero.
+ */
+static int libarchive_extract(struct archive_index *index, const char *fname,
+			      int map, uint8_t **data, uint32_t *size,
+			      int64_t *mtime)
 {
-	struct archive_cache *c = archive_cache_find(handle, fname);
+	struct archive_index_entry *e = archive_index_find(index, fname);
+	size_t total = 0;
 
-	if (!c)
+	if (!e)
 		return 1;
 
-	if (!c->has_data) {
-		/* TODO(hungte) Re-read. */
-		ERROR("Not in the cache: %s\n", fname);
+	if (libarchive_seek(index, e))
 		return 1;
-	}
 
-	if (mtime)
-		*mtime = c->mtime;
-	if (size)
-		*size = c->size;
-	*data = (uint8_t *)malloc(c->size + 1);
+	/* Decompress straight into the caller's buffer. */
+	*data = map ? archive_view_alloc(e->size) :
+		      (uint8_t *)malloc(e->size + 1);
 	if (!*data) {
-		ERROR("Out of memory when reading: %s\n", c->name);
+		ERROR("Out of memory when reading: %s\n", e->name);
 		return 1;
 	}
-	memcpy(*data, c->data, c->size);
-	(*data)[c->size] = '\0';
+	while (total < e->size) {
+		la_ssize_t r = archive_read_data(index->reader, *data + total,
+						 e->size - total);
+		if (r <= 0)
+			break;
+		total += r;
+	}
+	if (total != e->size) {
+		ERROR("Failed reading from archive: %s\n", e->name);
+		archive_read_free(index->reader);
+		index->reader = NULL;
+		if (map)
+			archive_view_release(index, *data, e->size);
+		else
+			free(*data);
+		*data = NULL;
+		return 1;
+	}
+	if (!map)
+		(*data)[e->size] = '\0';
+
+	if (mtime)
+		*mtime = e->mtime;
+	if (size)
+		*size = e->size;
 	return 0;
 }
 
+/* Callback for archive_read_file on an ARCHIVE file. */
+static int archive_libarchive_read_file(
+		void *handle, const char *fname, uint8_t **data,
+		uint32_t *size, int64_t *mtime)
+{
+	return libarchive_extract(handle, fname, 0, data, size, mtime);
+}
+
+/* Callback for archive_map_file on an ARCHIVE file. */
+static int archive_libarchive_map_file(
+		void *handle, const char *fname, uint8_t **data,
+		uint32_t *size, int64_t *mtime)
+{
+	return libarchive_extract(handle, fname, 1, data, size, mtime);
+}
+
 /* Callback for archive_write_file on an ARCHIVE file. */
 static int archive_libarchive_write_file(
 		void *handle, const char *fname, uint8_t *data, uint32_t size,
@@ -250,4 +385,6 @@ struct u_archive archive_libarchive = {
 	.has_entry = archive_libarchive_has_entry,
 	.read_file = archive_libarchive_read_file,
 	.write_file = archive_libarchive_write_file,
+	.map_file = archive_libarchive_map_file,
+	.release_file = archive_view_release,
 };
@@ -72,11 +72,14 @@ static int archive_zip_walk(
 	return 0;
 }
 
-/* Callback for archive_zip_read_file on a ZIP file. */
-static int archive_zip_read_file(void *handle, const char *fname,
-			     uint8_t **data, uint32_t *size, int64_t *mtime)
+/*
+ * Decompresses the entry fname into a new buffer, or a view if map is set.
+ * libzip doesn't tell where the data of stored entries is, so they can't be
+ * mapped directly.  Returns 0 on success, otherwise non-zero.
+ */
+static int zip_extract(struct zip *zip, const char *fname, int map,
+		       uint8_t **data, uint32_t *size, int64_t *mtime)
 {
-	struct zip *zip = (struct zip *)handle;
 	struct zip_file *fp;
 	struct zip_stat stat;
 
@@ -93,16 +96,21 @@ static int archive_zip_read_file(void *handle, const char *fname,
 		ERROR("Failed to open entry in ZIP: %s\n", fname);
 		return 1;
 	}
-	*data = (uint8_t *)malloc(stat.size + 1);
+	*data = map ? archive_view_alloc(stat.size) :
+		      (uint8_t *)malloc(stat.size + 1);
 	if (*data) {
 		if (zip_fread(fp, *data, stat.size) == stat.size) {
 			if (mtime)
 				*mtime = stat.mtime;
 			*size = stat.size;
-			(*data)[stat.size] = '\0';
+			if (!map)
+				(*data)[stat.size] = '\0';
 		} else {
 			ERROR("Failed to read entry in zip: %s\n", fname);
-			free(*data);
+			if (map)
+				archive_view_release(zip, *data, stat.size);
+			else
+				free(*data);
 			*data = NULL;
 		}
 	}
@@ -110,6 +118,26 @@ static int archive_zip_read_file(void *handle, const char *fname,
 	return *data == NULL;
 }
 
+/* Callback for archive_zip_read_file on a ZIP file. */
+static int archive_zip_read_file(void *handle, const char *fname,
+			     uint8_t **data, uint32_t *size, int64_t *mtime)
+{
+	struct zip *zip = (struct zip *)handle;
+
+	assert(zip);
+	return zip_extract(zip, fname, 0, data, size, mtime);
+}
+
+/* Callback for archive_map_file on a ZIP file. */
+static int archive_zip_map_file(void *handle, const char *fname,
+				uint8_t **data, uint32_t *size, int64_t *mtime)
+{
+	struct zip *zip = (struct zip *)handle;
+
+	assert(zip);
+	return zip_extract(zip, fname, 1, data, size, mtime);
+}
+
 /* Callback for archive_zip_write_file on a ZIP file. */
 static int archive_zip_write_file(void *handle, const char *fname,
 				  uint8_t *data, uint32_t size, int64_t mtime)
@@ -144,4 +172,6 @@ struct u_archive archive_zip = {
 	.has_entry = archive_zip_has_entry,
 	.read_file = archive_zip_read_file,
 	.write_file = archive_zip_write_file,
+	.map_file = archive_zip_map_file,
+	.release_file = archive_view_release,
 };
@@ -108,6 +108,46 @@ static int archive_libziparchive_read_file(void *handle, const char *fname, uint
 	return 0;
 }
 
+/* Callback for archive_map_file on a ZIP file. */
+static int archive_libziparchive_map_file(void *handle, const char *fname, uint8_t **data,
+					  uint32_t *size, int64_t *mtime)
+{
+	struct libziparchive_entry *entry = libziparchive_alloc_entry();
+	if (libziparchive_find_entry(handle, fname, entry)) {
+		fprintf(stderr, "ERROR: Failed to locate %s in the archive.\n", fname);
+		libziparchive_release_entry(entry);
+		return LIBZIPARCHIVE_WRAPPER_FAILURE;
+	}
+
+	size_t size64 = libziparchive_get_size(entry);
+	uint64_t offset;
+	int fd;
+
+	/* Stored entries are mapped from the archive, the rest extracted. */
+	if (!libziparchive_get_stored_data(handle, entry, &fd, &offset)) {
+		*data = archive_view_map(fd, offset, size64);
+	} else {
+		*data = archive_view_alloc(size64);
+		if (*data && libziparchive_extract_entry_to(handle, entry, *data, size64)) {
+			archive_view_release(handle, *data, size64);
+			*data = NULL;
+		}
+	}
+	if (!*data) {
+		fprintf(stderr, "ERROR: Failed to extract %s from the archive.\n", fname);
+		libziparchive_release_entry(entry);
+		return LIBZIPARCHIVE_WRAPPER_FAILURE;
+	}
+	*size = size64;
+
+	if (mtime)
+		*mtime = libziparchive_get_mtime(entry);
+
+	libziparchive_release_entry(entry);
+
+	return 0;
+}
+
 /* Callback for archive_zip_write_file on a ZIP file. */
 static int archive_libziparchive_write_file(void *handle, const char *fname, uint8_t *data,
 					    uint32_t size, int64_t mtime)
@@ -122,6 +162,8 @@ struct u_archive archive_libziparchive = {
 	.has_entry = archive_libziparchive_has_entry,
 	.read_file = archive_libziparchive_read_file,
 	.write_file = archive_libziparchive_write_file,
+	.map_file = archive_libziparchive_map_file,
+	.release_file = archive_view_release,
 };
 
 #endif
@@ -54,6 +54,7 @@ static struct option const long_opts[] = {
 	{"try", 0, NULL, 't'},
 	{"archive", 1, NULL, 'a'},
 	{"mode", 1, NULL, 'm'},
+	{"jobs", 1, NULL, 'j'},
 
 	{"check-fwid", 0, NULL, OPT_CHECK_FWID},
 	{"detect-model-only", 0, NULL, OPT_DETECT_MODEL_ONLY},
@@ -88,7 +89,7 @@ static struct option const long_opts[] = {
 };
 
 static const char *const short_opts =
-	"hdvi:e:ta:m:" SHARED_FLASH_ARGS_SHORTOPTS;
+	"hdvi:e:ta:m:j:" SHARED_FLASH_ARGS_SHORTOPTS;
 
 static void print_help(int argc, char *argv[])
 {
@@ -127,6 +128,8 @@ static void print_help(int argc, char *argv[])
 		"    --parseable-manifest\n"
 		"                    \tScan the archive to print a manifest\n"
 		"                    \tin shell-parseable format\n"
+		"-j, --jobs=NUM      \tLoad up to NUM images at once for\n"
+		"                    \t--manifest and --parseable-manifest\n"
 		"    --check-fwid    \tCompare firmware id before performing\n"
 		"                    \tan update. Skip the update if the versions are\n"
 		"                    \tthe same.\n"
@@ -178,6 +181,7 @@ static int do_update(int argc, char *argv[])
 	const char *prepare_ctrl_name = NULL;
 	char *servo_programmer = NULL;
 	char *endptr;
+	long jobs;
 	const char *sig = NULL;
 
 	struct updater_config *cfg = updater_new_config();
@@ -214,6 +218,15 @@ static int do_update(int argc, char *argv[])
 		case 'm':
 			args.mode = optarg;
 			break;
+		case 'j':
+			jobs = strtol(optarg, &endptr, 0);
+			if (*endptr || jobs < 1 || jobs > 256) {
+				ERROR("Invalid --jobs (must be 1-256): %s\n",
+				      optarg);
+				errorcnt++;
+			}
+			args.manifest_jobs = jobs;
+			break;
 
 		case OPT_REPACK:
 			args.repack = optarg;
@@ -326,6 +339,10 @@ static int do_update(int argc, char *argv[])
 		errorcnt++;
 		ERROR("Unexpected arguments.\n");
 	}
+	if (args.manifest_jobs && !args.do_manifest) {
+		errorcnt++;
+		ERROR("--jobs is only for --manifest and --parseable-manifest.\n");
+	}
 
 	if (!errorcnt && args.detect_servo) {
 		servo_programmer = host_detect_servo(&prepare_ctrl_name);
@@ -1160,6 +1160,124 @@ static enum updater_error_codes update_whole_firmware(
 	return UPDATE_ERR_DONE;
 }
 
+/*
+ * Decides which FMAP regions of the system firmware are needed for the update
+ * mode and stores them in regions, largest first so nested ones are skipped.
+ * Returns the number of regions, or 0 if the whole flash should be read.
+ */
+static size_t plan_system_firmware_regions(struct updater_config *cfg,
+					   bool wp_enabled,
+					   const char *regions[],
+					   size_t max_regions)
+{
+	const struct firmware_image *image_to = &cfg->image;
+	/* RO_SECTION (which has FMAP, RO_FRID and GBB) is only compared by
+	   TRY-RW updates when WP is off. */
+	const bool need_ro = cfg->try_update && !wp_enabled;
+	const struct {
+		const char *name;
+		bool required;
+	} candidates[] = {
+		{ need_ro ? FMAP_RO_SECTION : NULL, true },
+		{ FMAP_RO_FMAP, true },
+		{ FMAP_RO_FRID, true },
+		{ FMAP_RO_GBB, true },
+		{ FMAP_RW_SECTION_A, true },
+		{ FMAP_RW_SECTION_B, true },
+		{ FMAP_RW_SHARED, false },
+		{ FMAP_RW_LEGACY, false },
+	};
+	FmapAreaHeader *areas[ARRAY_SIZE(candidates)];
+	size_t i, j, num = 0;
+
+	/* Full update (and its preserved sections) needs everything. */
+	if (!wp_enabled && !cfg->try_update)
+		return 0;
+	/* The quirk writes back parts of the current image. */
+	if (get_config_quirk(QUIRK_CLEAR_MRC_DATA, cfg))
+		return 0;
+	if (!image_to->fmap_header)
+		return 0;
+
+	for (i = 0; i < ARRAY_SIZE(candidates); i++) {
+		const char *name = candidates[i].name;
+		FmapAreaHeader *ah = NULL;
+		bool nested = false;
+
+		if (!name)
+			continue;
+		if (!fmap_find_by_name(image_to->data, image_to->size,
+				       image_to->fmap_header, name, &ah)) {
+			if (candidates[i].required) {
+				VB2_DEBUG("No %s in target image.\n", name);
+				return 0;
+			}
+			continue;
+		}
+		for (j = 0; j < num && !nested; j++)
+			nested = (ah->area_offset >= areas[j]->area_offset &&
+				  ah->area_offset + ah->area_size <=
+				  areas[j]->area_offset + areas[j]->area_size);
+		if (nested)
+			continue;
+		if (num >= max_regions)
+			return 0;
+		areas[num] = ah;
+		regions[num++] = name;
+	}
+	return num;
+}
+
+/*
+ * Loads the current system firmware, reading only the regions the update
+ * needs if possible.
+ * Returns 0 on success, otherwise the error from load_system_firmware.
+ */
+static int load_current_firmware(struct updater_config *cfg, bool wp_enabled)
+{
+	struct firmware_image *image = &cfg->image_current;
+	const char *regions[8];
+	size_t i, num;
+	int r = -1;
+
+	num = plan_system_firmware_regions(cfg, wp_enabled, regions,
+					   ARRAY_SIZE(regions));
+	if (num) {
+		INFO("Reading regions:");
+		for (i = 0; i < num; i++)
+			fprintf(stderr, " %s", regions[i]);
+		fprintf(stderr, "\n");
+		r = load_system_firmware_regions(cfg, image, regions, num);
+		if (r) {
+			VB2_DEBUG("Failed reading regions, read all instead.\n");
+			free_firmware_image(image);
+		}
+	}
+	if (r)
+		r = load_system_firmware(cfg, image);
+	return r;
+}
+
+/*
+ * Re-reads the whole system firmware if only some regions were loaded.
+ * Returns 0 on success, otherwise failure.
+ */
+static int load_full_current_firmware(struct updater_config *cfg)
+{
+	struct firmware_image *image = &cfg->image_current;
+	int r;
+
+	if (!image->partial)
+		return 0;
+
+	INFO("Reading whole system firmware...\n");
+	free_firmware_image(image);
+	r = load_system_firmware(cfg, image);
+	if (r == IMAGE_PARSE_FAILURE && cfg->force_update)
+		r = 0;
+	return r;
+}
+
 enum updater_error_codes update_firmware(struct updater_config *cfg)
 {
 	bool done = false;
@@ -1218,7 +1336,7 @@ enum updater_error_codes update_firmware(struct updater_config *cfg)
 		int ret;
 
 		INFO("Loading current system firmware...\n");
-		ret = load_system_firmware(cfg, image_from);
+		ret = load_current_firmware(cfg, wp_enabled);
 		if (ret == IMAGE_PARSE_FAILURE && cfg->force_update) {
 			WARN("No compatible firmware in system.\n");
 			cfg->check_platform = 0;
@@ -1266,6 +1384,8 @@ enum updater_error_codes update_firmware(struct updater_config *cfg)
 	}
 
 	if (!done) {
+		if (!wp_enabled && load_full_current_firmware(cfg))
+			return UPDATE_ERR_SYSTEM_IMAGE;
 		if (!wp_enabled && is_ap_ro_locked_with_verification(cfg)) {
 			if (is_unlock_csme_requested(cfg))
 				return UPDATE_ERR_UNLOCK_CSME;
@@ -1664,9 +1784,9 @@ static int print_manifest(const struct updater_config_arguments *arg)
 			.models = &model,
 		};
 		if (arg->manifest_format == MANIFEST_PRINT_FORMAT_JSON) {
-			print_json_manifest(&manifest);
+			print_json_manifest(&manifest, arg->manifest_jobs);
 		} else if (arg->manifest_format == MANIFEST_PRINT_FORMAT_PARSEABLE) {
-			print_parseable_manifest(&manifest);
+			print_parseable_manifest(&manifest, arg->manifest_jobs);
 		} else {
 			ERROR("Unknown manifest format requested: %d", arg->manifest_format);
 			return 1;
@@ -1710,9 +1830,9 @@ static int print_manifest(const struct updater_config_arguments *arg)
 			return 1;
 		}
 		if (arg->manifest_format == MANIFEST_PRINT_FORMAT_JSON) {
-			print_json_manifest(manifest);
+			print_json_manifest(manifest, arg->manifest_jobs);
 		} else if (arg->manifest_format == MANIFEST_PRINT_FORMAT_PARSEABLE) {
-			print_parseable_manifest(manifest);
+			print_parseable_manifest(manifest, arg->manifest_jobs);
 		} else {
 			ERROR("Unknown manifest format requested: %d", arg->manifest_format);
 			delete_manifest(manifest);
@@ -122,6 +122,7 @@ struct updater_config_arguments {
 	char *repack, *unpack;
 	int is_factory, try_update, force_update, do_manifest, host_only;
 	enum manifest_print_format manifest_format;
+	int manifest_jobs;
 	int fast_update;
 	int verbosity;
 	int override_gbb_flags;
@@ -185,6 +186,9 @@ struct manifest {
 	struct model_config *models;
 	struct u_archive *archive;
 	int default_model;
+	/* Hash index of models by name, maintained by manifest_add_model. */
+	int *model_buckets, *model_next;
+	int num_model_buckets;
 };
 
 enum updater_error_codes {
@@ -315,6 +319,24 @@ int archive_has_entry(struct u_archive *ar, const char *name);
 int archive_read_file(struct u_archive *ar, const char *fname,
 		      uint8_t **data, uint32_t *size, int64_t *mtime);
 
+/*
+ * Maps a file from archive, without copying it where possible.  Files in a
+ * directory and stored (uncompressed) ZIP entries read with libziparchive are
+ * memory-mapped; anything else is decompressed into a view of its own.  Views
+ * are private: changes to them are never written back, and for mapped files
+ * only the pages which are changed take up extra memory.
+ * Returns 0 on success (data and size reflects the file content),
+ * otherwise non-zero as failure.  Unlike archive_read_file, the data is not
+ * NUL-terminated and must be released with archive_release_file.
+ */
+int archive_map_file(struct u_archive *ar, const char *fname,
+		     uint8_t **data, uint32_t *size, int64_t *mtime);
+
+/*
+ * Releases a file mapped by archive_map_file.
+ */
+void archive_release_file(struct u_archive *ar, uint8_t *data, uint32_t size);
+
 /*
  * Writes a file into archive.
  * If entry name (fname) is an absolute path (/file), always write into real
@@ -349,11 +371,17 @@ struct manifest *new_manifest_from_archive(struct u_archive *archive);
 /* Releases all resources allocated by given manifest object. */
 void delete_manifest(struct manifest *manifest);
 
-/* Prints the information of objects in manifest (models and images) in JSON. */
-void print_json_manifest(const struct manifest *manifest);
+/*
+ * Prints the information of objects in manifest (models and images) in JSON.
+ * The images are loaded by up to `jobs` threads.
+ */
+void print_json_manifest(const struct manifest *manifest, int jobs);
 
-/* Prints the manifest in parseable double-colon-separated tokens format. */
-void print_parseable_manifest(const struct manifest *manifest);
+/*
+ * Prints the manifest in parseable double-colon-separated tokens format.
+ * The images are loaded by up to `jobs` threads.
+ */
+void print_parseable_manifest(const struct manifest *manifest, int jobs);
 
 /*
  * Modifies a firmware image from patch information specified in model config.
@@ -6,6 +6,7 @@
  */
 
 #include <assert.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #if defined(__OpenBSD__)
 #include <sys/types.h>
@@ -15,6 +16,42 @@
 #include "updater.h"
 #include "archive/updater_archive.h"
 
+/*
+ * -- The views shared by all drivers. --
+ */
+
+uint8_t *archive_view_alloc(uint32_t size)
+{
+	/* Always map something, so a view is never NULL. */
+	void *data = mmap(NULL, size ? size : 1, PROT_READ | PROT_WRITE,
+			  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+	return data == MAP_FAILED ? NULL : (uint8_t *)data;
+}
+
+uint8_t *archive_view_map(int fd, uint64_t offset, uint32_t size)
+{
+	uint64_t delta = offset % sysconf(_SC_PAGESIZE);
+	void *data;
+
+	if (!size)
+		return archive_view_alloc(0);
+
+	data = mmap(NULL, size + delta, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+		    fd, offset - delta);
+	if (data == MAP_FAILED)
+		return NULL;
+	return (uint8_t *)data + delta;
+}
+
+void archive_view_release(void *handle, uint8_t *data, uint32_t size)
+{
+	uintptr_t delta = (uintptr_t)data % sysconf(_SC_PAGESIZE);
+
+	if (data)
+		munmap(data - delta, (size ? size : 1) + delta);
+}
+
 /*
  * -- The public functions for using u_archive. --
  */
@@ -92,21 +129,36 @@ struct u_archive *archive_open(const char *path)
 		free(ar);
 		return NULL;
 	}
+	pthread_mutex_init(&ar->lock, NULL);
 	return ar;
 }
 
 int archive_close(struct u_archive *ar)
 {
 	int r = ar->close(ar->handle);
+	pthread_mutex_destroy(&ar->lock);
 	free(ar);
 	return r;
 }
 
+/*
+ * The drivers keep state in their handles (for example the position of a
+ * libarchive reader), so the functions below which may be called from several
+ * threads at once take the lock of the archive.  archive_walk is not one of
+ * them, since its callback may use the archive.  Views are released without
+ * it, as that never touches the handle.
+ */
+
 int archive_has_entry(struct u_archive *ar, const char *name)
 {
+	int r;
+
 	if (!ar || *name == '/')
 		return archive_fallback.has_entry(NULL, name);
-	return ar->has_entry(ar->handle, name);
+	pthread_mutex_lock(&ar->lock);
+	r = ar->has_entry(ar->handle, name);
+	pthread_mutex_unlock(&ar->lock);
+	return r;
 }
 
 int archive_walk(struct u_archive *ar, void *arg,
@@ -120,17 +172,48 @@ int archive_walk(struct u_archive *ar, void *arg,
 int archive_read_file(struct u_archive *ar, const char *fname,
 		      uint8_t **data, uint32_t *size, int64_t *mtime)
 {
+	int r;
+
 	if (!ar || *fname == '/')
 		return archive_fallback.read_file(NULL, fname, data, size, mtime);
-	return ar->read_file(ar->handle, fname, data, size, mtime);
+	pthread_mutex_lock(&ar->lock);
+	r = ar->read_file(ar->handle, fname, data, size, mtime);
+	pthread_mutex_unlock(&ar->lock);
+	return r;
+}
+
+int archive_map_file(struct u_archive *ar, const char *fname,
+		     uint8_t **data, uint32_t *size, int64_t *mtime)
+{
+	int r;
+
+	if (!ar || *fname == '/')
+		return archive_fallback.map_file(NULL, fname, data, size, mtime);
+	pthread_mutex_lock(&ar->lock);
+	r = ar->map_file(ar->handle, fname, data, size, mtime);
+	pthread_mutex_unlock(&ar->lock);
+	return r;
+}
+
+void archive_release_file(struct u_archive *ar, uint8_t *data, uint32_t size)
+{
+	if (!ar)
+		archive_fallback.release_file(NULL, data, size);
+	else
+		ar->release_file(ar->handle, data, size);
 }
 
 int archive_write_file(struct u_archive *ar, const char *fname,
 		       uint8_t *data, uint32_t size, int64_t mtime)
 {
+	int r;
+
 	if (!ar || *fname == '/')
 		return archive_fallback.write_file(NULL, fname, data, size, mtime);
-	return ar->write_file(ar->handle, fname, data, size, mtime);
+	pthread_mutex_lock(&ar->lock);
+	r = ar->write_file(ar->handle, fname, data, size, mtime);
+	pthread_mutex_unlock(&ar->lock);
+	return r;
 }
 
 struct _copy_arg {
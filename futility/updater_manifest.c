@@ -6,6 +6,7 @@
  */
 
 #include <assert.h>
+#include <pthread.h>
 #if defined(__OpenBSD__)
 #include <sys/types.h>
 #endif
@@ -235,6 +236,81 @@ static void find_patches_for_model(struct model_config *model,
 	}
 }
 
+/* Returns the bucket of the model index for a model name. */
+static int manifest_model_bucket(const struct manifest *manifest,
+				 const char *name)
+{
+	/* FNV-1a */
+	uint32_t hash = 2166136261u;
+
+	for (; *name; name++) {
+		hash ^= (uint8_t)*name;
+		hash *= 16777619u;
+	}
+	return hash % manifest->num_model_buckets;
+}
+
+/* Returns the matched model config from the manifest, or NULL if not found. */
+static struct model_config *manifest_get_model_config(
+		const struct manifest *manifest, const char *name)
+{
+	int i = 0;
+
+	/* Manifests made up by the caller (see updater.c) have no index. */
+	if (!manifest->num_model_buckets) {
+		for (i = 0; i < manifest->num; i++) {
+			if (!strcmp(name, manifest->models[i].name))
+				return &manifest->models[i];
+		}
+		return NULL;
+	}
+
+	for (i = manifest->model_buckets[manifest_model_bucket(manifest, name)];
+	     i >= 0; i = manifest->model_next[i]) {
+		if (!strcmp(name, manifest->models[i].name))
+			return &manifest->models[i];
+	}
+	return NULL;
+}
+
+/*
+ * Adds models[i] to the model index of manifest. Only the first model of each
+ * name is indexed, so lookups find the same model as a linear search would.
+ */
+static void manifest_index_model(struct manifest *manifest, int i)
+{
+	const char *name = manifest->models[i].name;
+	int bucket;
+
+	if (manifest_get_model_config(manifest, name))
+		return;
+	bucket = manifest_model_bucket(manifest, name);
+	manifest->model_next[i] = manifest->model_buckets[bucket];
+	manifest->model_buckets[bucket] = i;
+}
+
+/*
+ * Rebuilds the model index of manifest with num_buckets buckets.
+ * Returns 0 on success, otherwise failure.
+ */
+static int manifest_reindex_models(struct manifest *manifest, int num_buckets)
+{
+	int *buckets = (int *)malloc(num_buckets * sizeof(*buckets));
+	int i;
+
+	if (!buckets)
+		return -1;
+	for (i = 0; i < num_buckets; i++)
+		buckets[i] = -1;
+	free(manifest->model_buckets);
+	manifest->model_buckets = buckets;
+	manifest->num_model_buckets = num_buckets;
+
+	for (i = 0; i < manifest->num; i++)
+		manifest_index_model(manifest, i);
+	return 0;
+}
+
 /*
  * Adds and copies one new model config to the existing list of given manifest.
  * Returns a pointer to the newly allocated config, or NULL on failure.
@@ -247,12 +323,26 @@ static struct model_config *manifest_add_model(
 	manifest->num++;
 	manifest->models = (struct model_config *)realloc(
 			manifest->models, manifest->num * sizeof(*model));
-	if (!manifest->models) {
+	manifest->model_next = (int *)realloc(
+			manifest->model_next,
+			manifest->num * sizeof(*manifest->model_next));
+	if (!manifest->models || !manifest->model_next) {
 		ERROR("Internal error: failed to allocate buffer.\n");
 		return NULL;
 	}
 	model = &manifest->models[manifest->num - 1];
 	memcpy(model, cfg, sizeof(*model));
+
+	/* Keep at least as many buckets as models. */
+	if (manifest->num > manifest->num_model_buckets) {
+		if (manifest_reindex_models(
+				manifest, VB2_MAX(64, 2 * manifest->num))) {
+			ERROR("Internal error: failed to allocate buffer.\n");
+			return NULL;
+		}
+	} else {
+		manifest_index_model(manifest, manifest->num - 1);
+	}
 	return model;
 }
 
@@ -294,19 +384,6 @@ static int manifest_scan_raw_entries(const char *name, void *arg)
 	return !manifest_add_model(manifest, &model);
 }
 
-/* Returns the matched model config from the manifest, or NULL if not found. */
-static struct model_config *manifest_get_model_config(
-		const struct manifest *manifest, const char *name)
-{
-	int i = 0;
-
-	for (i = 0; i < manifest->num; i++) {
-		if (!strcmp(name, manifest->models[i].name))
-			return &manifest->models[i];
-	}
-	return NULL;
-}
-
 /* Releases (and zeros) the data inside a patch config. */
 static void clear_patch_config(struct patch_config *patch)
 {
@@ -846,11 +923,15 @@ void delete_manifest(struct manifest *manifest)
 		clear_patch_config(&model->patches);
 	}
 	free(manifest->models);
+	free(manifest->model_buckets);
+	free(manifest->model_next);
 	free(manifest);
 }
 
+/* Returns the hash of a key in gbb, stored in hash if it can be computed. */
 static const char *get_gbb_key_hash(const struct vb2_gbb_header *gbb,
-				    int32_t offset, int32_t size)
+				    int32_t offset, int32_t size,
+				    char hash[VB2_SHA1_DIGEST_SIZE * 2 + 1])
 {
 	struct vb2_packed_key *key;
 
@@ -859,81 +940,356 @@ static const char *get_gbb_key_hash(const struct vb2_gbb_header *gbb,
 	key = (struct vb2_packed_key *)((uint8_t *)gbb + offset);
 	if (vb2_packed_key_looks_ok(key, size))
 		return "<Invalid key>";
-	return packed_key_sha1_string(key);
+	return packed_key_sha1_string_r(key, hash);
 }
 
-/* Prints the information of given image file in JSON format. */
-static void print_json_image(
-		const char *name, const char *fpath, struct model_config *m,
-		struct u_archive *archive, int indent, int is_host,
-		bool is_first)
+/*
+ * The information printed for an image of a model. Many models usually share
+ * one image, so the reports are collected for each image file in one go (see
+ * collect_image_reports) instead of loading and parsing it for every model.
+ */
+struct image_report {
+	const struct model_config *model;
+	const char *name;
+	const char *fpath;
+	bool is_host;
+	bool loaded;
+	char *ro_version, *rw_version, *ecrw_version;
+	/* Hashes of the keys in the patched GBB, or NULL if not available. */
+	char *root_key, *recovery_key;
+};
+
+/* The sections patch_image_by_model may change. */
+static const char * const patched_sections[] = {
+	FMAP_RO_GBB,
+	FMAP_RW_VBLOCK_A,
+	FMAP_RW_VBLOCK_B,
+	FMAP_RO_GSCVD,
+};
+
+/*
+ * The original content of patched_sections in an image, so the image can be
+ * patched for one model after another.
+ */
+struct patch_backup {
+	struct firmware_section sections[ARRAY_SIZE(patched_sections)];
+	uint8_t *saved[ARRAY_SIZE(patched_sections)];
+};
+
+/* Releases the saved sections in backup. */
+static void free_patch_backup(struct patch_backup *backup)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(patched_sections); i++)
+		free(backup->saved[i]);
+}
+
+/*
+ * Saves the sections in image that may be patched.
+ * Returns 0 on success, otherwise failure.
+ */
+static int save_patched_sections(struct patch_backup *backup,
+				 const struct firmware_image *image)
+{
+	int i;
+
+	memset(backup, 0, sizeof(*backup));
+	for (i = 0; i < ARRAY_SIZE(patched_sections); i++) {
+		struct firmware_section *section = &backup->sections[i];
+
+		find_firmware_section(section, image, patched_sections[i]);
+		if (!section->data)
+			continue;
+		backup->saved[i] = (uint8_t *)malloc(section->size);
+		if (!backup->saved[i]) {
+			free_patch_backup(backup);
+			return -1;
+		}
+		memcpy(backup->saved[i], section->data, section->size);
+	}
+	return 0;
+}
+
+/* Restores the sections saved by save_patched_sections. */
+static void restore_patched_sections(const struct patch_backup *backup)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(patched_sections); i++) {
+		const struct firmware_section *section = &backup->sections[i];
+
+		if (section->data)
+			memcpy(section->data, backup->saved[i], section->size);
+	}
+}
+
+/* Fills a report from an image, patching it for the model if needed. */
+static void fill_image_report(struct image_report *report,
+			      struct firmware_image *image,
+			      struct u_archive *archive)
 {
-	struct firmware_image image = {0};
 	const struct vb2_gbb_header *gbb = NULL;
-	if (!fpath)
+	char hash[VB2_SHA1_DIGEST_SIZE * 2 + 1];
+
+	report->loaded = true;
+	report->ro_version = strdup(image->ro_version);
+	report->rw_version = strdup(image->rw_version_a);
+	if (!report->is_host)
+		return;
+
+	if (image->ecrw_version_a[0] != '\0')
+		report->ecrw_version = strdup(image->ecrw_version_a);
+	if (patch_image_by_model(image, report->model, archive))
+		ERROR("Failed to patch images by model: %s\n",
+		      report->model->name);
+	else
+		gbb = find_gbb(image);
+	if (gbb) {
+		report->root_key = strdup(get_gbb_key_hash(
+				gbb, gbb->rootkey_offset, gbb->rootkey_size,
+				hash));
+		report->recovery_key = strdup(get_gbb_key_hash(
+				gbb, gbb->recovery_key_offset,
+				gbb->recovery_key_size, hash));
+	}
+}
+
+/* Orders reports by image file, then by their order in the manifest. */
+static int compare_image_reports(const void *a, const void *b)
+{
+	const struct image_report *ra = *(const struct image_report **)a,
+				  *rb = *(const struct image_report **)b;
+	int r = strcmp(ra->fpath, rb->fpath);
+
+	if (r)
+		return r;
+	return ra < rb ? -1 : ra > rb;
+}
+
+/*
+ * Some of the reports for one image file. Each job loads the file on its own,
+ * so the models sharing an image can be split among several jobs.
+ */
+struct image_job {
+	struct image_report **reports;
+	int num_reports;
+	/* Set in the first job of each file. */
+	bool check_versions;
+};
+
+struct image_pool {
+	pthread_mutex_t lock;
+	struct u_archive *archive;
+	struct image_job *jobs;
+	int num_jobs;
+	/* Next job for a worker to take. */
+	int next;
+};
+
+/* Fills the reports of a job from its image file. */
+static void run_image_job(const struct image_job *job,
+			  struct u_archive *archive)
+{
+	struct firmware_image image = {0};
+	struct patch_backup backup;
+	int i;
+
+	if (load_firmware_image(&image, job->reports[0]->fpath, archive))
 		return;
-	if (load_firmware_image(&image, fpath, archive))
+	if (save_patched_sections(&backup, &image)) {
+		ERROR("Internal error: memory allocation error.\n");
+		free_firmware_image(&image);
+		return;
+	}
+
+	for (i = 0; i < job->num_reports; i++) {
+		if (i && job->reports[i - 1]->is_host)
+			restore_patched_sections(&backup);
+		fill_image_report(job->reports[i], &image, archive);
+	}
+	free_patch_backup(&backup);
+	if (job->check_versions)
+		check_firmware_versions(&image);
+	free_firmware_image(&image);
+}
+
+static void *image_worker_main(void *arg)
+{
+	struct image_pool *pool = (struct image_pool *)arg;
+	int i;
+
+	while (1) {
+		pthread_mutex_lock(&pool->lock);
+		i = pool->next++;
+		pthread_mutex_unlock(&pool->lock);
+		if (i >= pool->num_jobs)
+			break;
+
+		run_image_job(&pool->jobs[i], pool->archive);
+	}
+	return NULL;
+}
+
+/* Runs all jobs in pool on up to num_threads threads, including this one. */
+static void run_image_jobs(struct image_pool *pool, int num_threads)
+{
+	pthread_t *threads = NULL;
+	int i, started = 0;
+
+	num_threads = VB2_MIN(num_threads, pool->num_jobs);
+	if (num_threads > 1)
+		threads = (pthread_t *)calloc(num_threads - 1,
+					      sizeof(*threads));
+	for (i = 0; threads && i < num_threads - 1; i++) {
+		if (pthread_create(&threads[i], NULL, image_worker_main, pool))
+			break;
+		started++;
+	}
+	/* Also does all the work if no thread could be started. */
+	image_worker_main(pool);
+
+	for (i = 0; i < started; i++)
+		pthread_join(threads[i], NULL);
+	free(threads);
+}
+
+/*
+ * Collects the reports of all images (host, then EC) of the models in manifest,
+ * in the order of the models. Images are loaded by up to num_threads threads.
+ * Each image file is loaded and parsed once per thread at most.
+ * Returns the reports, and sets num_reports to how many there are.
+ * The reports must be released by free_image_reports.
+ */
+static struct image_report *collect_image_reports(
+		const struct manifest *manifest, int num_threads,
+		int *num_reports)
+{
+	struct image_pool pool = {
+		.lock = PTHREAD_MUTEX_INITIALIZER,
+		.archive = manifest->archive,
+	};
+	struct image_report *reports, **sorted;
+	int i, j, k, per_job, num = 0;
+
+	reports = (struct image_report *)calloc(
+			2 * manifest->num, sizeof(*reports));
+	sorted = (struct image_report **)calloc(
+			2 * manifest->num, sizeof(*sorted));
+	pool.jobs = (struct image_job *)calloc(
+			2 * manifest->num, sizeof(*pool.jobs));
+	if (!reports || !sorted || !pool.jobs) {
+		ERROR("Internal error: memory allocation error.\n");
+		free(reports);
+		free(sorted);
+		free(pool.jobs);
+		*num_reports = 0;
+		return NULL;
+	}
+
+	for (i = 0; i < manifest->num; i++) {
+		const struct model_config *m = &manifest->models[i];
+		struct image_report host = {m, "host", m->image, true},
+				    ec = {m, "ec", m->ec_image, false};
+
+		if (host.fpath)
+			reports[num++] = host;
+		if (ec.fpath)
+			reports[num++] = ec;
+	}
+	for (i = 0; i < num; i++)
+		sorted[i] = &reports[i];
+	qsort(sorted, num, sizeof(*sorted), compare_image_reports);
+
+	/*
+	 * Split the reports of each file into jobs of at most per_job reports,
+	 * so files shared by more models get more jobs. With one thread, each
+	 * file is a single job.
+	 */
+	num_threads = VB2_MAX(num_threads, 1);
+	per_job = VB2_MAX(1, (num + num_threads - 1) / num_threads);
+	for (i = 0; i < num; i = j) {
+		for (j = i + 1; j < num && !strcmp(sorted[i]->fpath,
+						   sorted[j]->fpath); j++)
+			;
+		for (k = i; k < j; k += per_job) {
+			struct image_job *job = &pool.jobs[pool.num_jobs++];
+
+			job->reports = &sorted[k];
+			job->num_reports = VB2_MIN(per_job, j - k);
+			job->check_versions = k == i;
+		}
+	}
+
+	run_image_jobs(&pool, num_threads);
+
+	free(pool.jobs);
+	free(sorted);
+	*num_reports = num;
+	return reports;
+}
+
+/* Releases the reports from collect_image_reports. */
+static void free_image_reports(struct image_report *reports, int num_reports)
+{
+	int i;
+
+	for (i = 0; i < num_reports; i++) {
+		struct image_report *r = &reports[i];
+		free(r->ro_version);
+		free(r->rw_version);
+		free(r->ecrw_version);
+		free(r->root_key);
+		free(r->recovery_key);
+	}
+	free(reports);
+}
+
+/* Prints the information of given image file in JSON format. */
+static void print_json_image(const struct image_report *r, int indent,
+			     bool is_first)
+{
+	if (!r->loaded)
 		return;
 	if (!is_first)
 		printf(",\n");
-	printf("%*s\"%s\": {", indent, "", name);
+	printf("%*s\"%s\": {", indent, "", r->name);
 	indent += 2;
 	printf("\n%*s\"versions\": {", indent, "");
 	indent += 2;
-	printf("\n%*s\"ro\": \"%s\"", indent, "", image.ro_version);
-	printf(",\n%*s\"rw\": \"%s\"", indent, "", image.rw_version_a);
-	if (is_host && image.ecrw_version_a[0] != '\0')
-		printf(",\n%*s\"ecrw\": \"%s\"", indent, "",
-		       image.ecrw_version_a);
+	printf("\n%*s\"ro\": \"%s\"", indent, "", r->ro_version);
+	printf(",\n%*s\"rw\": \"%s\"", indent, "", r->rw_version);
+	if (r->ecrw_version)
+		printf(",\n%*s\"ecrw\": \"%s\"", indent, "", r->ecrw_version);
 	indent -= 2;
 	printf("\n%*s},", indent, "");
-	if (is_host) {
-		if (patch_image_by_model(&image, m, archive))
-			ERROR("Failed to patch images by model: %s\n", m->name);
-		else
-			gbb = find_gbb(&image);
-	}
-	if (gbb != NULL) {
+	if (r->root_key) {
 		printf("\n%*s\"keys\": { \"root\": \"%s\", ",
-		       indent, "",
-		       get_gbb_key_hash(gbb, gbb->rootkey_offset,
-					gbb->rootkey_size));
-		printf("\"recovery\": \"%s\" },",
-		       get_gbb_key_hash(gbb, gbb->recovery_key_offset,
-					gbb->recovery_key_size));
-	}
-	printf("\n%*s\"image\": \"%s\"", indent, "", fpath);
+		       indent, "", r->root_key);
+		printf("\"recovery\": \"%s\" },", r->recovery_key);
+	}
+	printf("\n%*s\"image\": \"%s\"", indent, "", r->fpath);
 	indent -= 2;
 	printf("\n%*s}", indent, "");
-	check_firmware_versions(&image);
-	free_firmware_image(&image);
 }
 
 /* Prints the information of objects in manifest (models and images) in JSON. */
-void print_json_manifest(const struct manifest *manifest)
+void print_json_manifest(const struct manifest *manifest, int jobs)
 {
-	int i, j, indent;
-	struct u_archive *ar = manifest->archive;
+	int i, indent, num_reports;
+	struct image_report *reports, *r;
+
+	reports = collect_image_reports(manifest, jobs, &num_reports);
+	r = reports;
 
 	printf("{\n");
 	for (i = 0, indent = 2; i < manifest->num; i++) {
 		struct model_config *m = &manifest->models[i];
-		struct {
-			const char *name;
-			const char *fpath;
-			bool is_host;
-		} images[] = {
-			{"host", m->image, true},
-			{"ec", m->ec_image},
-		};
 		bool is_first = true;
 		printf("%s%*s\"%s\": {\n", i ? ",\n" : "", indent, "", m->name);
 		indent += 2;
-		for (j = 0; j < ARRAY_SIZE(images); j++) {
-			if (!images[j].fpath)
-				continue;
-			print_json_image(images[j].name, images[j].fpath, m, ar,
-					 indent, images[j].is_host, is_first);
+		for (; r < reports + num_reports && r->model == m; r++) {
+			print_json_image(r, indent, is_first);
 			is_first = false;
 		}
 		if (m->patches.rootkey) {
@@ -951,55 +1307,43 @@ void print_json_manifest(const struct manifest *manifest)
 		assert(indent == 2);
 	}
 	printf("\n}\n");
+
+	free_image_reports(reports, num_reports);
 }
 
-static void print_parseable_image(const char *name, const char *fpath, struct model_config *m,
-				 struct u_archive *archive, bool is_host)
+static void print_parseable_image(const struct image_report *r)
 {
-	struct firmware_image image = {0};
-	const struct vb2_gbb_header *gbb = NULL;
+	const char *model = r->model->name;
 
-	if (!fpath)
+	if (!r->loaded)
 		return;
-	if (load_firmware_image(&image, fpath, archive))
-		return;
-
-	printf("%s::%s::versions::ro::%s\n", m->name, name, image.ro_version);
-	printf("%s::%s::versions::rw::%s\n", m->name, name, image.rw_version_a);
-	if (is_host) {
-		if (image.ecrw_version_a[0] != '\0')
-			printf("%s::%s::versions::ecrw::%s\n", m->name, name,
-			       image.ecrw_version_a);
 
-		if (patch_image_by_model(&image, m, archive))
-			ERROR("Failed to patch images by model: %s\n", m->name);
-		else
-			gbb = find_gbb(&image);
-
-		if (gbb != NULL) {
-			printf("%s::%s::keys::root::%s\n", m->name, name,
-			       get_gbb_key_hash(gbb, gbb->rootkey_offset, gbb->rootkey_size));
-			printf("%s::%s::keys::recovery::%s\n", m->name, name,
-			       get_gbb_key_hash(gbb, gbb->recovery_key_offset,
-						gbb->recovery_key_size));
-		}
+	printf("%s::%s::versions::ro::%s\n", model, r->name, r->ro_version);
+	printf("%s::%s::versions::rw::%s\n", model, r->name, r->rw_version);
+	if (r->ecrw_version)
+		printf("%s::%s::versions::ecrw::%s\n", model, r->name,
+		       r->ecrw_version);
+	if (r->root_key) {
+		printf("%s::%s::keys::root::%s\n", model, r->name, r->root_key);
+		printf("%s::%s::keys::recovery::%s\n", model, r->name,
+		       r->recovery_key);
 	}
-	printf("%s::%s::image::%s\n", m->name, name, fpath);
-	check_firmware_versions(&image);
-	free_firmware_image(&image);
+	printf("%s::%s::image::%s\n", model, r->name, r->fpath);
 }
 
-void print_parseable_manifest(const struct manifest *manifest)
+void print_parseable_manifest(const struct manifest *manifest, int jobs)
 {
-	struct u_archive *ar = manifest->archive;
+	int num_reports;
+	struct image_report *reports, *r;
+
+	reports = collect_image_reports(manifest, jobs, &num_reports);
+	r = reports;
 
 	for (int i = 0; i < manifest->num; ++i) {
 		struct model_config *m = &manifest->models[i];
-		if (m->image)
-			print_parseable_image("host", m->image, m, ar, true);
 
-		if (m->ec_image)
-			print_parseable_image("ec", m->ec_image, m, ar, false);
+		for (; r < reports + num_reports && r->model == m; r++)
+			print_parseable_image(r);
 
 		if (m->patches.rootkey) {
 			struct patch_config *p = &m->patches;
@@ -1010,4 +1354,6 @@ void print_parseable_manifest(const struct manifest *manifest)
 				printf("%s::gscvd::%s\n", m->name, p->gscvd);
 		}
 	}
+
+	free_image_reports(reports, num_reports);
 }
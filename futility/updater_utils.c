@@ -7,6 +7,7 @@
 
 #include <assert.h>
 #include <limits.h>
+#include <pthread.h>
 #include <stdbool.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -240,11 +241,13 @@ int load_firmware_image(struct firmware_image *image, const char *file_name,
 		ERROR("Does not exist: %s\n", file_name);
 		return IMAGE_READ_FAILURE;
 	}
-	if (archive_read_file(archive, file_name, &image->data, &image->size,
-			      NULL) != VB2_SUCCESS) {
+	/* Images are only patched in memory, so a private view will do. */
+	if (archive_map_file(archive, file_name, &image->data, &image->size,
+			     NULL) != VB2_SUCCESS) {
 		ERROR("Failed to load %s\n", file_name);
 		return IMAGE_READ_FAILURE;
 	}
+	image->data_mapped = true;
 
 	image->file_name = strdup(file_name);
 
@@ -291,7 +294,10 @@ void free_firmware_image(struct firmware_image *image)
 	 */
 	const char *programmer = image->programmer;
 
-	free(image->data);
+	if (image->data_mapped)
+		archive_release_file(NULL, image->data, image->size);
+	else
+		free(image->data);
 	free(image->file_name);
 	free(image->ro_version);
 	free(image->rw_version_a);
@@ -629,8 +635,10 @@ static int is_the_same_programmer(const struct firmware_image *image1,
 }
 
 test_mockable
-int load_system_firmware(struct updater_config *cfg,
-			 struct firmware_image *image)
+int load_system_firmware_regions(struct updater_config *cfg,
+				 struct firmware_image *image,
+				 const char * const regions[],
+				 const size_t regions_len)
 {
 	if (!strcmp(image->programmer, FLASHROM_PROGRAMMER_INTERNAL_EC))
 		WARN("%s: flashrom support for CrOS EC is EOL.\n", __func__);
@@ -644,13 +652,15 @@ int load_system_firmware(struct updater_config *cfg,
 		if (i > 1)
 			WARN("Retry reading firmware (%d/%d)...\n", i, tries);
 		INFO("Reading SPI Flash..\n");
-		if (flashrom_read_image(image, NULL, 0, verbose) == VB2_SUCCESS)
+		if (flashrom_read_image(image, regions, regions_len,
+					verbose) == VB2_SUCCESS)
 			r = 0;
 	}
 	if (r) {
 		/* Read failure, the content cannot be trusted. */
 		free_firmware_image(image);
 	} else {
+		image->partial = regions_len > 0;
 		/*
 		 * Parse the contents. Note the image->data will remain even
 		 * if parsing failed - this is important for system firmware
@@ -662,6 +672,13 @@ int load_system_firmware(struct updater_config *cfg,
 	return r;
 }
 
+test_mockable
+int load_system_firmware(struct updater_config *cfg,
+			 struct firmware_image *image)
+{
+	return load_system_firmware_regions(cfg, image, NULL, 0);
+}
+
 test_mockable
 int write_system_firmware(struct updater_config *cfg,
 			  const struct firmware_image *image,
@@ -676,7 +693,9 @@ int write_system_firmware(struct updater_config *cfg,
 	const int tries = 1 + get_config_quirk(QUIRK_EXTRA_RETRIES, cfg);
 	struct firmware_image *flash_contents = NULL;
 
+	/* Unread parts of a partial image would make flashrom skip them. */
 	if (cfg->use_diff_image && cfg->image_current.data &&
+	    !cfg->image_current.partial &&
 	    is_the_same_programmer(&cfg->image_current, image))
 		flash_contents = &cfg->image_current;
 
@@ -704,14 +723,18 @@ const char *create_temp_file(struct tempfile *head)
 {
 	struct tempfile *new_temp;
 	char new_path[] = VBOOT_TMP_DIR "/fwupdater.XXXXXX";
+	/* The umask is per process; keep other threads from restoring 077. */
+	static pthread_mutex_t umask_lock = PTHREAD_MUTEX_INITIALIZER;
 
 	int fd;
 	mode_t umask_save;
 
 	/* Set the umask before mkstemp for security considerations. */
+	pthread_mutex_lock(&umask_lock);
 	umask_save = umask(077);
 	fd = mkstemp(new_path);
 	umask(umask_save);
+	pthread_mutex_unlock(&umask_lock);
 	if (fd < 0) {
 		ERROR("Failed to create new temp file in %s\n", new_path);
 		return NULL;
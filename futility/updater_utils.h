@@ -80,6 +80,17 @@ struct updater_config;
 int load_system_firmware(struct updater_config *cfg,
 			 struct firmware_image *image);
 
+/*
+ * Same as load_system_firmware, but only reads the given FMAP regions (or the
+ * whole flash if regions_len is 0). The unread parts of image->data are left
+ * zeroed and image->partial is set, so the image must not be used where the
+ * real flash contents are needed.
+ */
+int load_system_firmware_regions(struct updater_config *cfg,
+				 struct firmware_image *image,
+				 const char * const regions[],
+				 const size_t regions_len);
+
 /* Frees the allocated resource from a firmware image object. */
 void free_firmware_image(struct firmware_image *image);
 
@@ -119,6 +119,9 @@ typedef struct CgptFindParams {
 	const char *label;
 	int hits;
 	int match_partnum;           /* 1-based; 0 means no match */
+	/* Number of drives to search at once; 0 or 1 searches one by one.
+	 * Matches are shown in the same order either way. */
+	int jobs;
 	/* when working with MTD, we actually work on a temp file, but we still
 	 * need to print the device name. so this parameter is here to properly
 	 * show the correct device name in that special case. */
@@ -36,6 +36,8 @@ int CgptGetNumNonEmptyPartitions(CgptShowParams *params);
 int CgptRepair(CgptRepairParams *params);
 int CgptPrioritize(CgptPrioritizeParams *params);
 void CgptFind(CgptFindParams *params);
+void CgptFindDrives(CgptFindParams *params, const char *const drive_names[],
+		    int count);
 int CgptLegacy(CgptLegacyParams *params);
 
 /* GUID conversion functions. Accepted format:
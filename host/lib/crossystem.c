@@ -39,7 +39,8 @@ typedef enum VdatStringField {
 	VDAT_STRING_LOAD_FIRMWARE_DEBUG,  /* LoadFirmware() debug info */
 	VDAT_STRING_DEPRECATED_LOAD_KERNEL_DEBUG,  /* vb2api_load_kernel()
 						      debug info */
-	VDAT_STRING_MAINFW_ACT  /* Active main firmware */
+	VDAT_STRING_MAINFW_ACT,  /* Active main firmware */
+	VDAT_STRING_BOOT_TIMING  /* Boot phase timing */
 } VdatStringField;
 
 
@@ -71,6 +72,14 @@ typedef enum VbBuildOption {
 } VbBuildOption;
 
 static const char *fw_results[] = {"unknown", "trying", "success", "failure"};
+static const char *timing_phases[VB2_TIMING_PHASE_COUNT] = {
+	[VB2_TIMING_GBB_READ] = "gbb_read",
+	[VB2_TIMING_KEYBLOCK_VERIFY] = "keyblock_verify",
+	[VB2_TIMING_PREAMBLE_VERIFY] = "preamble_verify",
+	[VB2_TIMING_BODY_HASH] = "body_hash",
+	[VB2_TIMING_RSA] = "rsa",
+	[VB2_TIMING_GPT_LOAD] = "gpt_load",
+};
 static const char *default_boot[] = {"disk", "usb", "altfw"};
 
 /* Masks for kern_nv usage by kernel. */
@@ -300,6 +309,45 @@ static int GetVdatLoadFirmwareDebug(char *dest, int size,
 	return 0;
 }
 
+static int GetVdatBootTiming(char *dest, int size,
+			     const VbSharedDataHeader *sh)
+{
+	struct vb2_boot_timing timing;
+	int used = 0;
+	uint32_t i;
+
+	/* Boot timing added in struct version 4 */
+	if (sh->struct_version < 4)
+		return -1;
+
+	memcpy(&timing, sh->boot_timing, sizeof(timing));
+	dest[0] = '\0';
+
+	for (i = 0; i < VB2_TIMING_PHASE_COUNT && used < size; i++) {
+		const struct vb2_timing_phase_record *p = &timing.phase[i];
+		used += snprintf(dest + used, size - used,
+				 "%s: count=%u start_ms=%u time_ms=%u "
+				 "bytes=%u\n", timing_phases[i], p->count,
+				 p->start_ms, p->elapsed_ms, p->bytes);
+	}
+
+	if (used < size)
+		used += snprintf(dest + used, size - used,
+				 "kernel_tries=%u\n", timing.kernel_try_count);
+
+	for (i = 0; i < timing.kernel_try_count &&
+		    i < VB2_TIMING_MAX_KERNEL_TRIES && used < size; i++) {
+		const struct vb2_timing_kernel_try *t = &timing.kernel_try[i];
+		used += snprintf(dest + used, size - used,
+				 "kernel_try: partition=%u start_ms=%u "
+				 "time_ms=%u bytes=%u result=%#x\n",
+				 t->partition, t->start_ms, t->elapsed_ms,
+				 t->bytes, t->result);
+	}
+
+	return 0;
+}
+
 static int GetVdatString(char *dest, int size, VdatStringField field)
 {
 	VbSharedDataHeader *sh = VbSharedDataRead();
@@ -313,6 +361,10 @@ static int GetVdatString(char *dest, int size, VdatStringField field)
 			value = GetVdatLoadFirmwareDebug(dest, size, sh);
 			break;
 
+		case VDAT_STRING_BOOT_TIMING:
+			value = GetVdatBootTiming(dest, size, sh);
+			break;
+
 		case VDAT_STRING_MAINFW_ACT:
 			switch(sh->firmware_index) {
 				case 0:
@@ -609,6 +661,8 @@ int VbGetSystemPropertyString(const char *name, char *dest, size_t size)
 	} else if (!strcasecmp(name, "vdat_lfdebug")) {
 		return GetVdatString(dest, size,
 				VDAT_STRING_LOAD_FIRMWARE_DEBUG);
+	} else if (!strcasecmp(name, "vdat_timing")) {
+		return GetVdatString(dest, size, VDAT_STRING_BOOT_TIMING);
 	} else if (!strcasecmp(name, "fw_try_next")) {
 		StrCopy(dest,
 			vb2_get_nv_storage(VB2_NV_TRY_NEXT) ? "B" : "A",
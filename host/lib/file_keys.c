@@ -5,7 +5,9 @@
  * Utility functions for file and key handling.
  */
 
+#include <errno.h>
 #include <fcntl.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -20,23 +22,204 @@
 #include "host_common.h"
 #include "signature_digest.h"
 
+/*
+ * SHA digests can't be split across threads, but reading a large file can
+ * overlap with hashing it.  A reader thread fills a ring of large chunks while
+ * the calling thread hashes the chunks that are already full.  Anything up to
+ * one chunk is just read and hashed in the calling thread.
+ */
+#define HASH_FD_CHUNK_SIZE (1024 * 1024)
+#define HASH_FD_CHUNKS 3
+#define HASH_FD_READ_SIZE (64 * 1024)
+
+struct hash_fd_pipe {
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	int fd;
+	/* Chunks filled by the reader and not yet hashed */
+	int filled;
+	/* Set by the hashing thread to make the reader give up */
+	bool abort;
+	uint8_t *buf[HASH_FD_CHUNKS];
+	/* Bytes in each chunk; 0 means end of file, -1 a read error */
+	ssize_t len[HASH_FD_CHUNKS];
+};
+
+static ssize_t read_full(int fd, uint8_t *buf, size_t size)
+{
+	size_t done = 0;
+
+	while (done < size) {
+		ssize_t n = read(fd, buf + done, size - done);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n < 0)
+			return -1;
+		if (n == 0)
+			break;
+		done += n;
+	}
+
+	return done;
+}
+
+static void *hash_fd_reader(void *arg)
+{
+	struct hash_fd_pipe *p = arg;
+	ssize_t len;
+	bool abort;
+	int i = 0;
+
+	do {
+		pthread_mutex_lock(&p->lock);
+		while (p->filled == HASH_FD_CHUNKS && !p->abort)
+			pthread_cond_wait(&p->cond, &p->lock);
+		abort = p->abort;
+		pthread_mutex_unlock(&p->lock);
+		if (abort)
+			break;
+
+		len = read_full(p->fd, p->buf[i], HASH_FD_CHUNK_SIZE);
+		p->len[i] = len;
+
+		pthread_mutex_lock(&p->lock);
+		p->filled++;
+		pthread_cond_signal(&p->cond);
+		pthread_mutex_unlock(&p->lock);
+
+		i = (i + 1) % HASH_FD_CHUNKS;
+	} while (len > 0);
+
+	return NULL;
+}
+
+static vb2_error_t hash_fd_serial(int fd, struct vb2_digest_context *ctx)
+{
+	uint8_t *buf;
+	vb2_error_t rv = VB2_SUCCESS;
+	ssize_t len;
+
+	buf = malloc(HASH_FD_READ_SIZE);
+	if (!buf)
+		return VB2_ERROR_UNKNOWN;
+
+	while ((len = read_full(fd, buf, HASH_FD_READ_SIZE)) > 0) {
+		rv = vb2_digest_extend(ctx, buf, len);
+		if (rv)
+			break;
+	}
+	if (len < 0)
+		rv = VB2_ERROR_UNKNOWN;
+
+	free(buf);
+	return rv;
+}
+
+static vb2_error_t hash_fd_threaded(int fd, struct vb2_digest_context *ctx)
+{
+	struct hash_fd_pipe p = {
+		.lock = PTHREAD_MUTEX_INITIALIZER,
+		.cond = PTHREAD_COND_INITIALIZER,
+		.fd = fd,
+	};
+	pthread_t reader;
+	vb2_error_t rv = VB2_SUCCESS;
+	ssize_t len;
+	int i;
+
+	p.buf[0] = malloc(HASH_FD_CHUNK_SIZE * HASH_FD_CHUNKS);
+	if (!p.buf[0])
+		return VB2_ERROR_UNKNOWN;
+	for (i = 1; i < HASH_FD_CHUNKS; i++)
+		p.buf[i] = p.buf[i - 1] + HASH_FD_CHUNK_SIZE;
+
+	if (pthread_create(&reader, NULL, hash_fd_reader, &p)) {
+		free(p.buf[0]);
+		return hash_fd_serial(fd, ctx);
+	}
+
+	for (i = 0; ; i = (i + 1) % HASH_FD_CHUNKS) {
+		pthread_mutex_lock(&p.lock);
+		while (!p.filled)
+			pthread_cond_wait(&p.cond, &p.lock);
+		pthread_mutex_unlock(&p.lock);
+
+		len = p.len[i];
+		if (len < 0)
+			rv = VB2_ERROR_UNKNOWN;
+		else if (len > 0)
+			rv = vb2_digest_extend(ctx, p.buf[i], len);
+		if (len <= 0 || rv)
+			break;
+
+		pthread_mutex_lock(&p.lock);
+		p.filled--;
+		pthread_cond_signal(&p.cond);
+		pthread_mutex_unlock(&p.lock);
+	}
+
+	pthread_mutex_lock(&p.lock);
+	p.abort = true;
+	pthread_cond_signal(&p.cond);
+	pthread_mutex_unlock(&p.lock);
+	pthread_join(reader, NULL);
+	free(p.buf[0]);
+
+	return rv;
+}
+
+bool vb2_hash_fd_use_thread(int fd)
+{
+	struct stat st;
+	off_t pos;
+
+	if (fstat(fd, &st) || !S_ISREG(st.st_mode))
+		return false;
+	pos = lseek(fd, 0, SEEK_CUR);
+
+	return pos >= 0 && st.st_size - pos > HASH_FD_CHUNK_SIZE;
+}
+
+vb2_error_t vb2_hash_fd(int fd, enum vb2_hash_algorithm alg,
+			struct vb2_hash *hash)
+{
+	struct vb2_digest_context ctx;
+	vb2_error_t rv;
+
+	rv = vb2_digest_init(&ctx, false, alg, 0);
+	if (rv)
+		return rv;
+
+	if (vb2_hash_fd_use_thread(fd))
+		rv = hash_fd_threaded(fd, &ctx);
+	else
+		rv = hash_fd_serial(fd, &ctx);
+	if (rv)
+		return rv;
+
+	hash->algo = alg;
+	return vb2_digest_finalize(&ctx, hash->raw, vb2_digest_size(alg));
+}
+
 vb2_error_t DigestFile(char *input_file, enum vb2_hash_algorithm alg,
 		       uint8_t *digest, uint32_t digest_size)
 {
-	int input_fd, len;
-	uint8_t data[VB2_SHA1_BLOCK_SIZE];
-	struct vb2_digest_context ctx;
+	struct vb2_hash hash;
+	vb2_error_t rv;
+	int input_fd;
+
+	if (digest_size < vb2_digest_size(alg))
+		return VB2_ERROR_SHA_FINALIZE_DIGEST_SIZE;
 
 	if ((input_fd = open(input_file, O_RDONLY)) == -1) {
 		fprintf(stderr, "Couldn't open %s\n", input_file);
 		return VB2_ERROR_UNKNOWN;
 	}
-	vb2_digest_init(&ctx, false, alg, 0);
-	while ((len = read(input_fd, data, sizeof(data))) == sizeof(data))
-		vb2_digest_extend(&ctx, data, len);
-	if (len != -1)
-		vb2_digest_extend(&ctx, data, len);
+	rv = vb2_hash_fd(input_fd, alg, &hash);
 	close(input_fd);
+	if (rv)
+		return rv;
 
-	return vb2_digest_finalize(&ctx, digest, digest_size);
+	memcpy(digest, hash.raw, vb2_digest_size(alg));
+	return VB2_SUCCESS;
 }
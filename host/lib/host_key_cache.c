@@ -0,0 +1,178 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Cache of unpacked public keys for host tools.
+ */
+
+#include "2common.h"
+#include "2packed_key.h"
+#include "2rsa.h"
+#include "2sha.h"
+#include "2sysincludes.h"
+#include "host_key_cache.h"
+
+struct vb2_key_cache_entry {
+	/* SHA-256 of the packed key algorithm and data */
+	uint8_t digest[VB2_SHA256_DIGEST_SIZE];
+	/* Value of cache->clock when last used; 0 if the entry is empty */
+	uint64_t last_used;
+	/* Private copy of the packed key, which key points into */
+	struct vb2_packed_key *packed;
+	struct vb2_public_key key;
+};
+
+struct vb2_key_cache {
+	uint32_t max_entries;
+	uint64_t clock;
+	struct vb2_key_cache_stats stats;
+	struct vb2_key_cache_entry *entries;
+};
+
+struct vb2_key_cache *vb2_key_cache_create(uint32_t max_entries)
+{
+	struct vb2_key_cache *cache;
+
+	if (!max_entries)
+		return NULL;
+
+	cache = calloc(1, sizeof(*cache));
+	if (!cache)
+		return NULL;
+
+	cache->entries = calloc(max_entries, sizeof(*cache->entries));
+	if (!cache->entries) {
+		free(cache);
+		return NULL;
+	}
+	cache->max_entries = max_entries;
+
+	return cache;
+}
+
+void vb2_key_cache_free(struct vb2_key_cache *cache)
+{
+	uint32_t i;
+
+	if (!cache)
+		return;
+
+	for (i = 0; i < cache->max_entries; i++)
+		free(cache->entries[i].packed);
+	free(cache->entries);
+	free(cache);
+}
+
+static struct vb2_key_cache *default_cache;
+
+static void free_default_cache(void)
+{
+	vb2_key_cache_free(default_cache);
+	default_cache = NULL;
+}
+
+struct vb2_key_cache *vb2_key_cache_default(void)
+{
+	if (!default_cache) {
+		default_cache =
+			vb2_key_cache_create(VB2_KEY_CACHE_DEFAULT_ENTRIES);
+		if (default_cache)
+			atexit(free_default_cache);
+	}
+
+	return default_cache;
+}
+
+vb2_error_t vb2_key_cache_unpack_buffer(struct vb2_key_cache *cache,
+					struct vb2_public_key *key,
+					const uint8_t *buf, uint32_t size)
+{
+	const struct vb2_packed_key *packed_key =
+		(const struct vb2_packed_key *)buf;
+	struct vb2_key_cache_entry *entry = NULL;
+	struct vb2_packed_key *copy;
+	struct vb2_digest_context dc;
+	uint8_t digest[VB2_SHA256_DIGEST_SIZE];
+	uint32_t i;
+
+	/* Fail exactly the same way an uncached unpack would */
+	VB2_TRY(vb2_unpack_key_buffer(key, buf, size));
+	if (!cache)
+		return VB2_SUCCESS;
+
+	/*
+	 * The unpacked key only depends on the algorithm and key data, so
+	 * the same key is found wherever and with whatever version it's
+	 * packed.
+	 */
+	VB2_TRY(vb2_digest_init(&dc, false, VB2_HASH_SHA256, 0));
+	VB2_TRY(vb2_digest_extend(&dc, (const uint8_t *)&packed_key->algorithm,
+				  sizeof(packed_key->algorithm)));
+	VB2_TRY(vb2_digest_extend(&dc, vb2_packed_key_data(packed_key),
+				  packed_key->key_size));
+	VB2_TRY(vb2_digest_finalize(&dc, digest, sizeof(digest)));
+
+	for (i = 0; i < cache->max_entries; i++) {
+		struct vb2_key_cache_entry *e = &cache->entries[i];
+
+		if (e->last_used &&
+		    !memcmp(e->digest, digest, sizeof(digest))) {
+			e->last_used = ++cache->clock;
+			cache->stats.hits++;
+			*key = e->key;
+			return VB2_SUCCESS;
+		}
+
+		/* Remember the empty or least recently used entry */
+		if (!entry || e->last_used < entry->last_used)
+			entry = e;
+	}
+
+	cache->stats.misses++;
+
+	/* Copy with the key data right after the header, then unpack that */
+	copy = malloc(sizeof(*copy) + packed_key->key_size);
+	if (!copy)
+		return VB2_SUCCESS;  /* key still points into buf */
+	*copy = *packed_key;
+	copy->key_offset = sizeof(*copy);
+	memcpy(copy + 1, vb2_packed_key_data(packed_key), packed_key->key_size);
+	if (vb2_unpack_key(key, copy) != VB2_SUCCESS) {
+		/* Can't happen for a key which unpacked from buf */
+		free(copy);
+		return vb2_unpack_key_buffer(key, buf, size);
+	}
+
+	if (entry->last_used) {
+		free(entry->packed);
+		cache->stats.evictions++;
+	} else {
+		cache->stats.entries++;
+	}
+
+	memcpy(entry->digest, digest, sizeof(digest));
+	entry->last_used = ++cache->clock;
+	entry->packed = copy;
+	entry->key = *key;
+
+	return VB2_SUCCESS;
+}
+
+vb2_error_t vb2_key_cache_unpack(struct vb2_key_cache *cache,
+				 struct vb2_public_key *key,
+				 const struct vb2_packed_key *packed_key)
+{
+	if (!packed_key)
+		return VB2_ERROR_UNPACK_KEY_BUFFER;
+
+	return vb2_key_cache_unpack_buffer(cache, key,
+					   (const uint8_t *)packed_key,
+					   packed_key->key_offset +
+					   packed_key->key_size);
+}
+
+void vb2_key_cache_get_stats(const struct vb2_key_cache *cache,
+			     struct vb2_key_cache_stats *stats)
+{
+	*stats = cache->stats;
+}
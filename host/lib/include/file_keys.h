@@ -10,6 +10,20 @@
 
 #include "2sha.h"
 
+/* Calculates the digest of everything left to read from [fd] with the hash
+ * algorithm [alg] and stores it into [hash].  If vb2_hash_fd_use_thread()
+ * says so, the file is read in large chunks by a separate thread, so reading
+ * overlaps with hashing.  Returns VB2_SUCCESS, or non-zero on error.
+ */
+vb2_error_t vb2_hash_fd(int fd, enum vb2_hash_algorithm alg,
+			struct vb2_hash *hash);
+
+/* Returns true if vb2_hash_fd() would read [fd] on a separate thread, which
+ * is only worth it for a regular file with more than one large chunk left to
+ * read.  Other files are read and hashed in the calling thread.
+ */
+bool vb2_hash_fd_use_thread(int fd);
+
 /* Calculates the appropriate digest for the data in [input_file] based on the
  * hash algorithm [alg] and stores it into [digest], which is of size
  * [digest_size].  Returns VB2_SUCCESS, or non-zero on error.
@@ -5,6 +5,7 @@
  * Host utilites to execute flashrom command.
  */
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include "2return_codes.h"
@@ -24,6 +25,8 @@ struct firmware_image {
 	const char *programmer;
 	uint32_t size; /* buffer size. */
 	uint8_t *data; /* data allocated buffer to read/write with. */
+	bool data_mapped; /* data is a view from archive_map_file. */
+	bool partial; /* only some FMAP regions of data were read. */
 	char *file_name;
 	char *ro_version, *rw_version_a, *rw_version_b;
 	/* AP RW sections may contain a special ECRW binary for syncing EC
@@ -0,0 +1,98 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Cache of unpacked public keys for host tools.
+ */
+
+#ifndef VBOOT_REFERENCE_HOST_KEY_CACHE_H_
+#define VBOOT_REFERENCE_HOST_KEY_CACHE_H_
+
+#include "2return_codes.h"
+#include "2sysincludes.h"
+
+struct vb2_packed_key;
+struct vb2_public_key;
+
+/* Number of keys the default cache holds */
+#define VB2_KEY_CACHE_DEFAULT_ENTRIES 16
+
+struct vb2_key_cache;
+
+struct vb2_key_cache_stats {
+	uint64_t hits;
+	uint64_t misses;
+	uint64_t evictions;
+	/* Keys currently held */
+	uint32_t entries;
+};
+
+/**
+ * Create a key cache.
+ *
+ * The cache holds a private copy of each packed key it has unpacked, so
+ * unpacked keys stay valid after the caller frees the buffer they came from.
+ * Once max_entries keys are held, the least recently used one is evicted.
+ *
+ * @param max_entries	Maximum number of keys to hold (at least 1)
+ * @return The new cache, or NULL if error.  Free with vb2_key_cache_free().
+ */
+struct vb2_key_cache *vb2_key_cache_create(uint32_t max_entries);
+
+/**
+ * Free a key cache.  Keys unpacked from it are no longer valid.
+ *
+ * @param cache		Cache to free; ok to pass NULL (ignored).
+ */
+void vb2_key_cache_free(struct vb2_key_cache *cache);
+
+/**
+ * Return the process-wide key cache, creating it on first use with
+ * VB2_KEY_CACHE_DEFAULT_ENTRIES entries.
+ *
+ * @return The cache, or NULL if it couldn't be allocated.
+ */
+struct vb2_key_cache *vb2_key_cache_default(void);
+
+/**
+ * Unpack a key through the cache, like vb2_unpack_key_buffer().
+ *
+ * Keys are looked up by the SHA-256 of the packed key algorithm and data.
+ * The returned key points into the cache's copy and stays valid until that
+ * entry is evicted or the cache is freed, so use it before unpacking more
+ * than max_entries other keys.  Keys which fail to unpack aren't cached.
+ *
+ * @param cache		Cache to use; if NULL, unpacks without caching.
+ * @param key		Destination for the unpacked key
+ * @param buf		Pointer to packed key
+ * @param size		Size of buffer in bytes
+ * @return VB2_SUCCESS, or non-zero error code if error.
+ */
+vb2_error_t vb2_key_cache_unpack_buffer(struct vb2_key_cache *cache,
+					struct vb2_public_key *key,
+					const uint8_t *buf, uint32_t size);
+
+/**
+ * Unpack a key through the cache, like vb2_unpack_key().
+ *
+ * See vb2_key_cache_unpack_buffer().
+ *
+ * @param cache		Cache to use; if NULL, unpacks without caching.
+ * @param key		Destination for the unpacked key
+ * @param packed_key	Packed key to unpack
+ * @return VB2_SUCCESS, or non-zero error code if error.
+ */
+vb2_error_t vb2_key_cache_unpack(struct vb2_key_cache *cache,
+				 struct vb2_public_key *key,
+				 const struct vb2_packed_key *packed_key);
+
+/**
+ * Get the hit, miss and eviction counters of a cache.
+ *
+ * @param cache		Cache to query
+ * @param stats		Destination for the counters
+ */
+void vb2_key_cache_get_stats(const struct vb2_key_cache *cache,
+			     struct vb2_key_cache_stats *stats);
+
+#endif  /* VBOOT_REFERENCE_HOST_KEY_CACHE_H_ */
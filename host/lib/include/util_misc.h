@@ -29,6 +29,16 @@ struct pkcs11_key;
  */
 const char *packed_key_sha1_string(const struct vb2_packed_key *key);
 
+/**
+ * Like packed_key_sha1_string(), but into a buffer of the caller.
+ *
+ * @param key		Key to print digest for
+ * @param dest		Buffer of at least VB2_SHA1_DIGEST_SIZE * 2 + 1 chars
+ *
+ * @return dest
+ */
+char *packed_key_sha1_string_r(const struct vb2_packed_key *key, char *dest);
+
 /**
  * Returns the SHA1 digest of the private key data as a string.
  *
@@ -22,12 +22,11 @@
 #include "openssl_compat.h"
 #include "util_misc.h"
 
-const char *packed_key_sha1_string(const struct vb2_packed_key *key)
+char *packed_key_sha1_string_r(const struct vb2_packed_key *key, char *dest)
 {
 	uint8_t *buf = ((uint8_t *)key) + key->key_offset;
 	uint32_t buflen = key->key_size;
 	struct vb2_hash hash;
-	static char dest[VB2_SHA1_DIGEST_SIZE * 2 + 1];
 
 	vb2_hash_calculate(false, buf, buflen, VB2_HASH_SHA1, &hash);
 
@@ -39,6 +38,13 @@ const char *packed_key_sha1_string(const struct vb2_packed_key *key)
 	return dest;
 }
 
+const char *packed_key_sha1_string(const struct vb2_packed_key *key)
+{
+	static char dest[VB2_SHA1_DIGEST_SIZE * 2 + 1];
+
+	return packed_key_sha1_string_r(key, dest);
+}
+
 const char *private_key_sha1_string(const struct vb2_private_key *key)
 {
 	uint8_t *buf;
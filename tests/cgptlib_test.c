@@ -1479,6 +1479,12 @@ static int GptUpdateTest(void)
 	EXPECT(0 == GetEntryTries(e2 + KERNEL_B));
 	/* And that's caused the GPT to need updating */
 	EXPECT(0x0F == gpt->modified);
+	/* But only that entry, and the CRCs still check out */
+	EXPECT(KERNEL_B == gpt->dirty_entries_start);
+	EXPECT(KERNEL_B + 1 == gpt->dirty_entries_end);
+	EXPECT(GPT_SUCCESS == GptValidityCheck(gpt));
+	EXPECT(MASK_BOTH == gpt->valid_headers);
+	EXPECT(MASK_BOTH == gpt->valid_entries);
 
 	/* Another kernel with tries */
 	boot = GptNextKernelEntry(gpt);
@@ -1500,6 +1506,22 @@ static int GptUpdateTest(void)
 	EXPECT(0 == GetEntrySuccessful(boot));
 	EXPECT(0 == GetEntryPriority(boot));
 	EXPECT(0 == GetEntryTries(boot));
+	/* The dirty range covers both kernels updated so far */
+	EXPECT(KERNEL_B == gpt->dirty_entries_start);
+	EXPECT(KERNEL_X + 1 == gpt->dirty_entries_end);
+	EXPECT(GPT_SUCCESS == GptValidityCheck(gpt));
+	EXPECT(MASK_BOTH == gpt->valid_entries);
+
+	/* Once the whole table has been rewritten, it stays that way */
+	gpt->valid_entries = MASK_PRIMARY;
+	GptRepair(gpt);
+	EXPECT(0 == gpt->dirty_entries_end);
+	SetEntryPriority(e + KERNEL_A, 3);
+	EXPECT(GPT_SUCCESS == GptEntriesModified(gpt, KERNEL_A, 1));
+	EXPECT(0 == gpt->dirty_entries_end);
+	EXPECT(3 == GetEntryPriority(e2 + KERNEL_A));
+	EXPECT(GPT_SUCCESS == GptValidityCheck(gpt));
+	EXPECT(MASK_BOTH == gpt->valid_entries);
 
 	/* Can't update if entry isn't a kernel, or there isn't an entry */
 	memcpy(&e[KERNEL_X].type, &guid_rootfs, sizeof(guid_rootfs));
@@ -1765,6 +1787,8 @@ int main(int argc, char *argv[])
 		{ TEST_CASE(UpdateInvalidKernelTypeTest), },
 		{ TEST_CASE(DuplicateUniqueGuidTest), },
 		{ TEST_CASE(TestCrc32TestVectors), },
+		{ TEST_CASE(TestCrc32Implementations), },
+		{ TEST_CASE(TestCrc32Update), },
 		{ TEST_CASE(ErrorTextTest), },
 		{ TEST_CASE(CheckHeaderOffDevice), },
 		{ TEST_CASE(GptFindEntryByNameTest), },
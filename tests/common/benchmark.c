@@ -0,0 +1,98 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Sampling and reporting for micro-benchmarks.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "benchmark.h"
+#include "timer_utils.h"
+
+static uint64_t sample(benchmark_fn setup, benchmark_fn fn, void *arg)
+{
+	ClockTimerState ct;
+
+	if (setup)
+		setup(arg);
+
+	StartTimer(&ct);
+	fn(arg);
+	StopTimer(&ct);
+
+	return GetDurationNsecs(&ct);
+}
+
+static int compare_u64(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *)a;
+	uint64_t y = *(const uint64_t *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+void benchmark_summarize(uint64_t *ns, uint32_t count,
+			 struct benchmark_result *result)
+{
+	qsort(ns, count, sizeof(*ns), compare_u64);
+
+	result->samples = count;
+	result->min_ns = ns[0];
+	result->median_ns = ns[count / 2];
+	/* Nearest-rank percentile */
+	result->p99_ns = ns[(count * 99 + 99) / 100 - 1];
+}
+
+int benchmark_run(benchmark_fn setup, benchmark_fn fn, void *arg,
+		  struct benchmark_result *result)
+{
+	uint64_t *ns;
+	uint64_t first;
+	uint32_t count, i;
+
+	/* The first sample warms up caches, and sizes the run */
+	first = sample(setup, fn, arg);
+	count = BENCHMARK_BUDGET_NS / (first ? first : 1);
+	if (count < BENCHMARK_MIN_SAMPLES)
+		count = BENCHMARK_MIN_SAMPLES;
+	if (count > BENCHMARK_MAX_SAMPLES)
+		count = BENCHMARK_MAX_SAMPLES;
+
+	ns = malloc(count * sizeof(*ns));
+	if (!ns)
+		return 1;
+
+	for (i = 0; i < count; i++)
+		ns[i] = sample(setup, fn, arg);
+
+	benchmark_summarize(ns, count, result);
+
+	free(ns);
+	return 0;
+}
+
+void benchmark_report(const char *name, const struct benchmark_result *result,
+		      uint64_t bytes)
+{
+	double mbytes_per_sec = 0;
+
+	fprintf(stdout, "%s_median_ns:%" PRIu64 "\n", name, result->median_ns);
+	fprintf(stdout, "%s_p99_ns:%" PRIu64 "\n", name, result->p99_ns);
+
+	if (bytes) {
+		/* Bytes per nanosecond is Gbytes/sec */
+		mbytes_per_sec = bytes * 1000.0 /
+			(result->median_ns ? result->median_ns : 1);
+		fprintf(stdout, "%s_mbytes_per_sec:%f\n", name, mbytes_per_sec);
+		fprintf(stderr, "# %s: median %" PRIu64 " ns, p99 %" PRIu64
+			" ns, %.1f Mbytes/sec (%u samples)\n", name,
+			result->median_ns, result->p99_ns, mbytes_per_sec,
+			result->samples);
+	} else {
+		fprintf(stderr, "# %s: median %" PRIu64 " ns, p99 %" PRIu64
+			" ns (%u samples)\n", name, result->median_ns,
+			result->p99_ns, result->samples);
+	}
+}
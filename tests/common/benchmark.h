@@ -0,0 +1,54 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Sampling and reporting for micro-benchmarks.
+ */
+
+#ifndef VBOOT_REFERENCE_COMMON_BENCHMARK_H_
+#define VBOOT_REFERENCE_COMMON_BENCHMARK_H_
+
+#include <inttypes.h>
+
+/* Time to spend sampling each benchmark, after the first sample */
+#define BENCHMARK_BUDGET_NS (100ULL * 1000 * 1000)
+
+/* Bounds on the number of samples taken of each benchmark */
+#define BENCHMARK_MIN_SAMPLES 10
+#define BENCHMARK_MAX_SAMPLES 10000
+
+struct benchmark_result {
+	uint32_t samples;
+	uint64_t min_ns;
+	uint64_t median_ns;
+	uint64_t p99_ns;
+};
+
+typedef void (*benchmark_fn)(void *arg);
+
+/*
+ * Time fn(arg) repeatedly.  If setup isn't NULL, setup(arg) is called before
+ * each sample, outside the timed region.  As many samples are taken as fit in
+ * BENCHMARK_BUDGET_NS, within the sample count bounds.
+ *
+ * Returns 0 on success, or non-zero if out of memory.
+ */
+int benchmark_run(benchmark_fn setup, benchmark_fn fn, void *arg,
+		  struct benchmark_result *result);
+
+/*
+ * Summarize samples collected by the caller.  count must be at least 1.  The
+ * samples are sorted in place.
+ */
+void benchmark_summarize(uint64_t *ns, uint32_t count,
+			 struct benchmark_result *result);
+
+/*
+ * Print a result as machine-readable "<name>_<metric>:<value>" lines on
+ * stdout, and a "#" comment line for humans on stderr.  If bytes is non-zero,
+ * that much data was processed per sample, and throughput is also printed.
+ */
+void benchmark_report(const char *name, const struct benchmark_result *result,
+		      uint64_t bytes);
+
+#endif  /* VBOOT_REFERENCE_COMMON_BENCHMARK_H_ */
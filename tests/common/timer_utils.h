@@ -23,4 +23,7 @@ void StopTimer(ClockTimerState* ct);
 /* Get duration in milliseconds. */
 uint32_t GetDurationMsecs(ClockTimerState* ct);
 
+/* Get duration in nanoseconds. */
+uint64_t GetDurationNsecs(ClockTimerState* ct);
+
 #endif  /* VBOOT_REFERENCE_COMMON_TIMER_UTILS_H_ */
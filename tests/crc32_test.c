@@ -6,6 +6,7 @@
 #include "cgptlib_test.h"
 #include "common/tests.h"
 #include "crc32.h"
+#include "crc32_private.h"
 #include "crc32_test.h"
 
 #define MAX_VECTOR_LEN 256
@@ -45,3 +46,98 @@ int TestCrc32TestVectors(void) {
 	}
 	return TEST_OK;
 }
+
+/* Every implementation must match the bytewise reference, at any length and
+   alignment. */
+int TestCrc32Implementations(void) {
+	static uint8_t buf[16384 + 64];
+	static const uint32_t lens[] = {
+		0, 1, 7, 8, 9, 15, 16, 63, 64, 65, 127, 128, 200, 512,
+		16384, 16384 + 17,
+	};
+	uint32_t seed = 1;
+	uint32_t expect, crc;
+	int i, j, offset;
+
+	for (i = 0; i < sizeof(buf); i++) {
+		seed = seed * 1103515245 + 12345;
+		buf[i] = seed >> 16;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(lens); i++) {
+		for (offset = 0; offset < 8; offset++) {
+			const uint8_t *p = buf + offset;
+			uint32_t len = lens[i];
+
+			expect = Crc32Bytewise(~0U, p, len);
+
+			EXPECT(Crc32Slice8(~0U, p, len) == expect);
+
+			/* Split at every possible misalignment */
+			for (j = 0; j < 8 && j <= len; j++) {
+				crc = Crc32Slice8(~0U, p, j);
+				crc = Crc32Slice8(crc, p + j, len - j);
+				EXPECT(crc == expect);
+			}
+
+			/* With and without the accelerated implementations */
+			crc32_accel_mask = 0;
+			EXPECT(Crc32(p, len) == (expect ^ ~0U));
+			crc32_accel_mask = ~0U;
+			EXPECT(Crc32(p, len) == (expect ^ ~0U));
+
+#ifdef X86_CRC32_PCLMUL
+			uint32_t chunk = len & ~15U;
+			if (Crc32PclmulSupported() &&
+			    chunk >= CRC32_PCLMUL_MIN_LEN) {
+				crc = Crc32Pclmul(~0U, p, chunk);
+				crc = Crc32Bytewise(crc, p + chunk,
+						    len - chunk);
+				EXPECT(crc == expect);
+			}
+#endif
+#ifdef ARMV8_CRC32
+			if (Crc32Armv8Supported())
+				EXPECT(Crc32Armv8(~0U, p, len) == expect);
+#endif
+		}
+	}
+
+	return TEST_OK;
+}
+
+/* Updating the CRC for a changed range must match recomputing it. */
+int TestCrc32Update(void) {
+	static uint8_t buf[16384];
+	static const struct {
+		uint32_t len, offset, size;
+	} cases[] = {
+		{16384, 0, 128}, {16384, 128, 128}, {16384, 16256, 128},
+		{16384, 0, 16384}, {16384, 5000, 1}, {16384, 300, 0},
+		{512, 511, 1}, {1, 0, 1}, {0, 0, 0},
+	};
+	uint8_t old_data[16384];
+	uint32_t seed = 7;
+	uint32_t crc;
+	int i, j;
+
+	for (i = 0; i < sizeof(buf); i++) {
+		seed = seed * 1103515245 + 12345;
+		buf[i] = seed >> 16;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(cases); i++) {
+		uint8_t *p = buf + cases[i].offset;
+
+		crc = Crc32(buf, cases[i].len);
+		memcpy(old_data, p, cases[i].size);
+		for (j = 0; j < cases[i].size; j++)
+			p[j] ^= (j * 31 + i) | 1;
+
+		crc = Crc32Update(crc, cases[i].len, cases[i].offset,
+				  old_data, p, cases[i].size);
+		EXPECT(crc == Crc32(buf, cases[i].len));
+	}
+
+	return TEST_OK;
+}
@@ -7,5 +7,7 @@
 #define VBOOT_REFERENCE_CRC32_TEST_H_
 
 int TestCrc32TestVectors(void);
+int TestCrc32Implementations(void);
+int TestCrc32Update(void);
 
 #endif  /* VBOOT_REFERENCE_CRC32_TEST_H_ */
@@ -0,0 +1,592 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Micro-benchmarks of the crypto used by verified boot: hashing, RSA public
+ * exponentiation, HMAC, and keyblock and firmware preamble verification.
+ *
+ * Results go to stdout as "<name>_median_ns:<value>" and
+ * "<name>_p99_ns:<value>" lines, plus "<name>_mbytes_per_sec:<value>" where
+ * throughput makes sense.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "2api.h"
+#include "2common.h"
+#include "2hmac.h"
+#include "2rsa.h"
+#include "2rsa_private.h"
+#include "2sha.h"
+#include "2sha_private.h"
+#include "2sysincludes.h"
+#include "common/benchmark.h"
+#include "host_common.h"
+#include "host_key.h"
+#include "host_keyblock.h"
+#include "host_signature.h"
+
+static int failed;
+
+/*****************************************************************************/
+/* Digests */
+
+static const uint32_t digest_chunk_sizes[] = {
+	64, 512, 4 * 1024, 64 * 1024, 1024 * 1024, 16 * 1024 * 1024,
+};
+
+#define DIGEST_BUFFER_SIZE (16 * 1024 * 1024)
+
+/* Transform implementations, selected through vb2_sha_accel_mask */
+struct sha_impl {
+	const char *name;
+	uint32_t accel_mask;
+};
+
+static const struct sha_impl sha_impls[] = {
+	{ "generic", 0 },
+#ifdef X86_SHA_AVX2
+	{ "avx2", VB2_SHA_ACCEL_AVX2 },
+#endif
+#ifdef ARMV8_SHA_CE
+	{ "armv8", VB2_SHA_ACCEL_ARMV8 },
+#endif
+};
+
+/* Returns true if the accelerated transforms in vb2_sha_accel_mask (which
+   may be none) handle algorithm alg on this CPU. */
+static bool sha_impl_applies(enum vb2_hash_algorithm alg)
+{
+	if (!vb2_sha_accel_mask)
+		return true;
+
+	switch (alg) {
+#ifdef ARMV8_SHA_CE
+	case VB2_HASH_SHA1:
+		return vb2_sha1_armv8_supported();
+#endif
+	case VB2_HASH_SHA224:
+	case VB2_HASH_SHA256:
+#ifdef X86_SHA_AVX2
+		return vb2_sha_avx2_supported();
+#else
+		return false;
+#endif
+	case VB2_HASH_SHA384:
+	case VB2_HASH_SHA512:
+#ifdef X86_SHA_AVX2
+		if (vb2_sha_avx2_supported())
+			return true;
+#endif
+#ifdef ARMV8_SHA_CE
+		if (vb2_sha512_armv8_supported())
+			return true;
+#endif
+		return false;
+	default:
+		return false;
+	}
+}
+
+struct digest_bench {
+	enum vb2_hash_algorithm alg;
+	const uint8_t *buf;
+	uint32_t size;
+	struct vb2_digest_context dc;
+};
+
+static void digest_setup(void *arg)
+{
+	struct digest_bench *b = arg;
+
+	vb2_digest_init(&b->dc, false, b->alg, b->size);
+}
+
+static void digest_extend(void *arg)
+{
+	struct digest_bench *b = arg;
+
+	vb2_digest_extend(&b->dc, b->buf, b->size);
+}
+
+static void hwcrypto_digest_setup(void *arg)
+{
+	struct digest_bench *b = arg;
+
+	vb2ex_hwcrypto_digest_init(b->alg, b->size);
+}
+
+static void hwcrypto_digest_extend(void *arg)
+{
+	struct digest_bench *b = arg;
+
+	vb2ex_hwcrypto_digest_extend(b->buf, b->size);
+}
+
+static void run(const char *name, benchmark_fn setup, benchmark_fn fn,
+		void *arg, uint64_t bytes)
+{
+	struct benchmark_result result;
+
+	if (benchmark_run(setup, fn, arg, &result)) {
+		fprintf(stderr, "%s: out of memory\n", name);
+		failed = 1;
+		return;
+	}
+	benchmark_report(name, &result, bytes);
+}
+
+static void bench_digests(void)
+{
+	struct digest_bench b;
+	uint8_t *buf = malloc(DIGEST_BUFFER_SIZE);
+	char name[128];
+	const char *alg_name;
+	int i, c, m;
+
+	if (!buf) {
+		fprintf(stderr, "Error allocating digest buffer\n");
+		failed = 1;
+		return;
+	}
+	memset(buf, 0xa5, DIGEST_BUFFER_SIZE);
+	b.buf = buf;
+
+	for (i = VB2_HASH_SHA1; i < VB2_HASH_ALG_COUNT; i++) {
+		b.alg = i;
+		alg_name = vb2_get_hash_algorithm_name(i);
+
+		for (c = 0; c < ARRAY_SIZE(digest_chunk_sizes); c++) {
+			b.size = digest_chunk_sizes[c];
+
+			/* The fastest transforms available, as used by vboot */
+			snprintf(name, sizeof(name), "digest_%s_%u", alg_name,
+				 b.size);
+			run(name, digest_setup, digest_extend, &b, b.size);
+
+			/* Each implementation which handles this algorithm */
+			for (m = 0; m < ARRAY_SIZE(sha_impls); m++) {
+				vb2_sha_accel_mask = sha_impls[m].accel_mask;
+				if (!sha_impl_applies(i))
+					continue;
+				snprintf(name, sizeof(name), "digest_%s_%u_%s",
+					 alg_name, b.size, sha_impls[m].name);
+				run(name, digest_setup, digest_extend, &b,
+				    b.size);
+			}
+			vb2_sha_accel_mask = ~0U;
+
+			/* The hardware crypto engine, if linked in */
+			if (vb2ex_hwcrypto_digest_init(i, b.size))
+				continue;
+			snprintf(name, sizeof(name), "digest_%s_%u_hwcrypto",
+				 alg_name, b.size);
+			run(name, hwcrypto_digest_setup, hwcrypto_digest_extend,
+			    &b, b.size);
+		}
+	}
+
+	free(buf);
+}
+
+/*****************************************************************************/
+/* RSA public exponentiation */
+
+/* One crypto algorithm for each signature algorithm */
+static const enum vb2_crypto_algorithm rsa_algs[] = {
+	VB2_ALG_RSA1024_SHA256,
+	VB2_ALG_RSA2048_SHA256,
+	VB2_ALG_RSA2048_EXP3_SHA256,
+	VB2_ALG_RSA3072_EXP3_SHA256,
+	VB2_ALG_RSA4096_SHA256,
+	VB2_ALG_RSA8192_SHA256,
+};
+
+enum modexp_impl {
+	MODEXP_32,
+	MODEXP_64,
+	MODEXP_HWCRYPTO,
+	MODEXP_SSE2,
+	MODEXP_AVX2,
+	MODEXP_COUNT
+};
+
+static const char *const modexp_impl_names[MODEXP_COUNT] = {
+	"32", "64", "hwcrypto", "sse2", "avx2",
+};
+
+struct modexp_bench {
+	enum modexp_impl impl;
+	const struct vb2_public_key *key;
+	int exp;
+	uint32_t size;
+	uint8_t input[8192 / 8];
+	uint8_t buf[8192 / 8];
+	/* Enough for the SSE2 engine with RSA-8192 */
+	uint8_t workbuf[12 * 1024] __attribute__((aligned(16)));
+};
+
+static int rsa_exponent(enum vb2_signature_algorithm sig_alg)
+{
+	switch (sig_alg) {
+	case VB2_SIG_RSA2048_EXP3:
+	case VB2_SIG_RSA3072_EXP3:
+		return 3;
+	default:
+		return 65537;
+	}
+}
+
+/* Returns non-zero if the implementation isn't available. */
+static vb2_error_t modexp(struct modexp_bench *b)
+{
+	switch (b->impl) {
+	case MODEXP_32:
+		vb2_modexp32(b->key, b->buf, b->workbuf, b->exp);
+		return VB2_SUCCESS;
+#ifdef VB2_MODEXP64
+	case MODEXP_64:
+		vb2_modexp64(b->key, b->buf, b->exp);
+		return VB2_SUCCESS;
+#endif
+	case MODEXP_HWCRYPTO:
+		return vb2ex_hwcrypto_modexp(b->key, b->buf, b->workbuf,
+					     sizeof(b->workbuf), b->exp);
+#ifdef VB2_X86_RSA_ACCELERATION
+	case MODEXP_SSE2:
+		return vb2_modexp_sse2(b->key, b->buf, b->workbuf,
+				       sizeof(b->workbuf), b->exp);
+#endif
+#if defined(VB2_X86_RSA_ACCELERATION) && defined(VB2_X86_RSA_AVX2)
+	case MODEXP_AVX2:
+		if (!vb2_modexp_avx2_supported())
+			return VB2_ERROR_EX_HWCRYPTO_UNSUPPORTED;
+		return vb2_modexp_avx2(b->key, b->buf, b->workbuf,
+				       sizeof(b->workbuf), b->exp);
+#endif
+	default:
+		return VB2_ERROR_EX_HWCRYPTO_UNSUPPORTED;
+	}
+}
+
+static void modexp_setup(void *arg)
+{
+	struct modexp_bench *b = arg;
+
+	memcpy(b->buf, b->input, b->size);
+}
+
+static void modexp_run(void *arg)
+{
+	modexp(arg);
+}
+
+static void bench_modexp(const char *keys_dir)
+{
+	static struct modexp_bench b;
+	struct vb2_packed_key *packed;
+	struct vb2_public_key key;
+	uint8_t expect[8192 / 8];
+	char filename[1024];
+	char name[128];
+	const char *alg_name;
+	int i, j, m;
+
+	for (i = 0; i < ARRAY_SIZE(rsa_algs); i++) {
+		alg_name = vb2_get_crypto_algorithm_file(rsa_algs[i]);
+		snprintf(filename, sizeof(filename), "%s/key_%s.keyb",
+			 keys_dir, alg_name);
+		packed = vb2_read_packed_keyb(filename, rsa_algs[i], 1);
+		if (!packed || vb2_unpack_key(&key, packed)) {
+			fprintf(stderr, "Error reading key %s\n", filename);
+			free(packed);
+			failed = 1;
+			continue;
+		}
+
+		b.key = &key;
+		b.exp = rsa_exponent(key.sig_alg);
+		b.size = key.arrsize * sizeof(uint32_t);
+		for (j = 0; j < b.size; j++)
+			b.input[j] = (uint8_t)(j * 7);
+		b.input[0] = 0;  /* Keep the input below the modulus */
+
+		for (m = 0; m < MODEXP_COUNT; m++) {
+			b.impl = m;
+			modexp_setup(&b);
+			if (modexp(&b)) {
+				fprintf(stderr, "# %s modexp_%s not "
+					"available\n", alg_name,
+					modexp_impl_names[m]);
+				continue;
+			}
+
+			/* All implementations must agree with the first */
+			if (m == MODEXP_32) {
+				memcpy(expect, b.buf, b.size);
+			} else if (memcmp(expect, b.buf, b.size)) {
+				fprintf(stderr, "# %s modexp_%s result "
+					"mismatch!\n", alg_name,
+					modexp_impl_names[m]);
+				failed = 1;
+			}
+
+			snprintf(name, sizeof(name), "modexp_%s_%s", alg_name,
+				 modexp_impl_names[m]);
+			run(name, modexp_setup, modexp_run, &b, 0);
+		}
+
+		free(packed);
+	}
+}
+
+/*****************************************************************************/
+/* HMAC */
+
+static const enum vb2_hash_algorithm hmac_algs[] = {
+	VB2_HASH_SHA1,
+	VB2_HASH_SHA256,
+	VB2_HASH_SHA512,
+};
+
+static const uint32_t hmac_msg_sizes[] = { 64, 1024, 64 * 1024 };
+
+struct hmac_bench {
+	enum vb2_hash_algorithm alg;
+	uint8_t key[32];
+	uint8_t msg[64 * 1024];
+	uint32_t msg_size;
+	struct vb2_hash mac;
+};
+
+static void hmac_run(void *arg)
+{
+	struct hmac_bench *b = arg;
+
+	vb2_hmac_calculate(false, b->alg, b->key, sizeof(b->key), b->msg,
+			   b->msg_size, &b->mac);
+}
+
+static void bench_hmac(void)
+{
+	static struct hmac_bench b;
+	char name[128];
+	int i, s;
+
+	memset(b.key, 0x5c, sizeof(b.key));
+	memset(b.msg, 0xa5, sizeof(b.msg));
+
+	for (i = 0; i < ARRAY_SIZE(hmac_algs); i++) {
+		b.alg = hmac_algs[i];
+		for (s = 0; s < ARRAY_SIZE(hmac_msg_sizes); s++) {
+			b.msg_size = hmac_msg_sizes[s];
+			snprintf(name, sizeof(name), "hmac_%s_%u",
+				 vb2_get_hash_algorithm_name(b.alg),
+				 b.msg_size);
+			run(name, NULL, hmac_run, &b, b.msg_size);
+		}
+	}
+}
+
+/*****************************************************************************/
+/* Keyblock and firmware preamble verification */
+
+struct verify_bench {
+	const struct vb2_public_key *key;
+	/* Verification overwrites the signature, so verify a copy */
+	const uint8_t *pristine;
+	uint8_t *copy;
+	uint32_t size;
+	vb2_error_t (*verify)(struct verify_bench *b, struct vb2_workbuf *wb);
+	vb2_error_t rv;
+	uint8_t *workbuf;
+	uint32_t workbuf_size;
+};
+
+static vb2_error_t verify_keyblock(struct verify_bench *b,
+				   struct vb2_workbuf *wb)
+{
+	return vb2_verify_keyblock((struct vb2_keyblock *)b->copy, b->size,
+				   b->key, wb);
+}
+
+static vb2_error_t verify_fw_preamble(struct verify_bench *b,
+				      struct vb2_workbuf *wb)
+{
+	return vb2_verify_fw_preamble((struct vb2_fw_preamble *)b->copy,
+				      b->size, b->key, wb);
+}
+
+static void verify_setup(void *arg)
+{
+	struct verify_bench *b = arg;
+
+	memcpy(b->copy, b->pristine, b->size);
+}
+
+static void verify_run(void *arg)
+{
+	struct verify_bench *b = arg;
+	struct vb2_workbuf wb;
+
+	vb2_workbuf_init(&wb, b->workbuf, b->workbuf_size);
+	b->rv = b->verify(b, &wb);
+}
+
+static void bench_one_verify(const char *name, struct verify_bench *b,
+			     struct vb2_public_key *key, const void *data,
+			     uint32_t size)
+{
+	static struct modexp_bench probe;
+	char hw_name[128];
+	int k;
+
+	b->key = key;
+	b->pristine = data;
+	b->size = size;
+	b->copy = malloc(size);
+	if (!b->copy) {
+		fprintf(stderr, "%s: out of memory\n", name);
+		failed = 1;
+		return;
+	}
+
+	for (k = 0; k < 2; k++) {
+		key->allow_hwcrypto = k;
+		if (k) {
+			/* Only worth timing if there's an engine for it */
+			probe.impl = MODEXP_HWCRYPTO;
+			probe.key = key;
+			probe.exp = rsa_exponent(key->sig_alg);
+			if (modexp(&probe))
+				break;
+		}
+
+		verify_setup(b);
+		verify_run(b);
+		if (b->rv) {
+			fprintf(stderr, "%s: verification failed (%#x)\n",
+				name, b->rv);
+			failed = 1;
+			break;
+		}
+
+		if (k) {
+			snprintf(hw_name, sizeof(hw_name), "%s_hwcrypto",
+				 name);
+			run(hw_name, verify_setup, verify_run, b, 0);
+		} else {
+			run(name, verify_setup, verify_run, b, 0);
+		}
+	}
+
+	key->allow_hwcrypto = false;
+	free(b->copy);
+}
+
+static void bench_verify(const char *keys_dir)
+{
+	static struct verify_bench b;
+	struct vb2_private_key *private_key;
+	struct vb2_packed_key *packed, *data_key;
+	struct vb2_public_key key;
+	struct vb2_keyblock *keyblock;
+	struct vb2_signature *body_sig;
+	struct vb2_fw_preamble *preamble;
+	char filename[1024];
+	char name[128];
+	const char *alg_name;
+	int i;
+
+	/* Keyblocks carry a data key; its type doesn't affect the cost */
+	snprintf(filename, sizeof(filename), "%s/key_rsa2048.keyb", keys_dir);
+	data_key = vb2_read_packed_keyb(filename, VB2_ALG_RSA2048_SHA256, 1);
+	if (!data_key) {
+		fprintf(stderr, "Error reading key %s\n", filename);
+		failed = 1;
+		return;
+	}
+
+	/* The firmware body itself isn't hashed during preamble checks */
+	body_sig = vb2_alloc_signature(VB2_SHA256_DIGEST_SIZE, 0x100000);
+	b.workbuf_size = VB2_VERIFY_FIRMWARE_PREAMBLE_WORKBUF_BYTES;
+	b.workbuf = malloc(b.workbuf_size);
+	if (!body_sig || !b.workbuf) {
+		fprintf(stderr, "Error allocating verify buffers\n");
+		free(body_sig);
+		free(data_key);
+		failed = 1;
+		return;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(rsa_algs); i++) {
+		alg_name = vb2_get_crypto_algorithm_file(rsa_algs[i]);
+
+		snprintf(filename, sizeof(filename), "%s/key_%s.pem",
+			 keys_dir, alg_name);
+		private_key = vb2_read_private_key_pem(filename, rsa_algs[i]);
+		snprintf(filename, sizeof(filename), "%s/key_%s.keyb",
+			 keys_dir, alg_name);
+		packed = vb2_read_packed_keyb(filename, rsa_algs[i], 1);
+		if (!private_key || !packed || vb2_unpack_key(&key, packed)) {
+			fprintf(stderr, "Error reading %s keys\n", alg_name);
+			vb2_free_private_key(private_key);
+			free(packed);
+			failed = 1;
+			continue;
+		}
+
+		keyblock = vb2_create_keyblock(data_key, private_key, 0);
+		if (keyblock) {
+			snprintf(name, sizeof(name), "verify_keyblock_%s",
+				 alg_name);
+			b.verify = verify_keyblock;
+			bench_one_verify(name, &b, &key, keyblock,
+					 keyblock->keyblock_size);
+			free(keyblock);
+		} else {
+			fprintf(stderr, "Error creating %s keyblock\n",
+				alg_name);
+			failed = 1;
+		}
+
+		preamble = vb2_create_fw_preamble(1, data_key, body_sig,
+						  private_key, 0);
+		if (preamble) {
+			snprintf(name, sizeof(name), "verify_fw_preamble_%s",
+				 alg_name);
+			b.verify = verify_fw_preamble;
+			bench_one_verify(name, &b, &key, preamble,
+					 preamble->preamble_size);
+			free(preamble);
+		} else {
+			fprintf(stderr, "Error creating %s preamble\n",
+				alg_name);
+			failed = 1;
+		}
+
+		vb2_free_private_key(private_key);
+		free(packed);
+	}
+
+	free(b.workbuf);
+	free(body_sig);
+	free(data_key);
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc != 2) {
+		fprintf(stderr, "Usage: %s <keys_dir>\n", argv[0]);
+		return -1;
+	}
+
+	bench_digests();
+	bench_modexp(argv[1]);
+	bench_hmac();
+	bench_verify(argv[1]);
+
+	return failed;
+}
@@ -309,6 +309,36 @@ test_update() {
   fi
 }
 
+# Like test_update, but also checks which regions of the current firmware were
+# read. Each word of "reads" is a region which must be read first, "!REGION"
+# for one which must not, "all" if the whole flash must be read first, or
+# "rest" if the rest of the flash must be read later.
+test_update_reads() {
+  local test_name="$1"
+  local emu_src="$2"
+  local expected="$3"
+  local reads="$4"
+  local emu="${TMP}/emu"
+  local msg
+  local regions
+  local read
+
+  shift 4
+  cp -f "${emu_src}" "${emu}"
+  echo "*** Test Item: ${test_name}"
+  msg="$("${FUTILITY}" update --emulate "${emu}" "$@" 2>&1)"
+  cmp "${emu}" "${expected}"
+  regions="$(sed -n 's/.*Reading regions://p' <<<"${msg}")"
+  for read in ${reads}; do
+    case "${read}" in
+      all) test -z "${regions}" ;;
+      rest) grep -qF "Reading whole system firmware" <<<"${msg}" ;;
+      !*) test "$(grep -cw -- "${read#!}" <<<"${regions}")" = 0 ;;
+      *) grep -qw -- "${read}" <<<"${regions}" ;;
+    esac
+  done
+}
+
 # --sys_props: mainfw_act, tpm_fwver, platform_ver, [wp_hw, wp_sw]
 # tpm_fwver = <data key version:16><firmware version:16>.
 # TO_IMAGE is signed with data key version = 1, firmware version = 4 => 0x10004.
@@ -444,6 +474,31 @@ test_update "RW update -> fallback to RO+RW Full update (TPM Anti-rollback)" \
   "${FROM_IMAGE}" "!Firmware version rollback detected (6->4)" \
   -i "${TO_IMAGE}" -t --wp=0 --sys_props 1,0x10006
 
+# Test reading only the regions of the current firmware an update needs. The
+# expected images are built from whole images, so they are also what a full
+# read gives.
+RW_READS="FMAP RO_FRID GBB RW_SECTION_A RW_SECTION_B RW_SHARED RW_LEGACY"
+test_update_reads "Partial read (Full update)" \
+  "${FROM_IMAGE}" "${EXPECTED}/full" "all" \
+  -i "${TO_IMAGE}" --wp=0
+
+test_update_reads "Partial read (RW update)" \
+  "${FROM_IMAGE}" "${EXPECTED}/rw" "${RW_READS} !RO_SECTION" \
+  -i "${TO_IMAGE}" --wp=1
+
+test_update_reads "Partial read (RW update, A->B)" \
+  "${FROM_IMAGE}" "${EXPECTED}/b" "${RW_READS} !RO_SECTION" \
+  -i "${TO_IMAGE}" -t --wp=1 --sys_props 0
+
+test_update_reads "Partial read (RW update, same RO, wp=0, A->B)" \
+  "${FROM_SAME_RO_IMAGE}" "${EXPECTED}/FROM_SAME_RO_IMAGE.b" \
+  "RO_SECTION RW_SECTION_A RW_SECTION_B !RO_FRID !GBB" \
+  -i "${TO_IMAGE}" -t --wp=0 --sys_props 0
+
+test_update_reads "Partial read (RW update -> fallback to RO+RW Full update)" \
+  "${FROM_IMAGE}" "${EXPECTED}/full" "RO_SECTION rest" \
+  -i "${TO_IMAGE}" -t --wp=0 --sys_props 1,0x10002
+
 # Test 'factory mode'
 test_update "Factory mode update (WP=0)" \
   "${FROM_IMAGE}" "${EXPECTED}/full" \
@@ -598,6 +653,18 @@ diff -u \
   <(sort "${TMP_PARSEABLE_OUT}") \
   <(sort "${SCRIPT_DIR}/futility/link_image.manifest.parseable")
 
+echo "TEST: Manifest (--manifest, -a, image.bin, -j 4)"
+"${FUTILITY}" update -a "${A}" --manifest >"${TMP_JSON_OUT}"
+"${FUTILITY}" update -a "${A}" --manifest -j 4 >"${TMP_JSON_OUT}.j4"
+cmp "${TMP_JSON_OUT}" "${TMP_JSON_OUT}.j4"
+
+test_update "Full update (-j without --manifest)" \
+  "${FROM_IMAGE}" "!--jobs is only for --manifest" \
+  -i "${TO_IMAGE}" --wp=0 -j 4
+test_update "Manifest (--manifest, -j 257)" \
+  "${FROM_IMAGE}" "!Invalid --jobs (must be 1-256)" \
+  -a "${A}" --manifest -j 257
+
 cp -f "${TO_IMAGE}" "${A}/image.bin"
 test_update "Full update (--archive, single package)" \
   "${FROM_IMAGE}" "${EXPECTED}/full" \
@@ -622,6 +689,20 @@ cp -f "${LINK_BIOS}" "${A}/images/bios_link.bin"
 cp -f "${TMP_TO}/rootkey" "${A}/keyset/rootkey.customtip-cl"
 cp -f "${TMP_TO}/VBLOCK_A" "${A}/keyset/vblock_A.customtip-cl"
 cp -f "${TMP_TO}/VBLOCK_B" "${A}/keyset/vblock_B.customtip-cl"
+
+# Several models share an image here, so its reports may be split over jobs.
+# The output must still be the same as with one thread.
+echo "TEST: Manifest (--manifest, -a, unified build, -j 4)"
+"${FUTILITY}" update -a "${A}" --manifest >"${TMP_JSON_OUT}"
+"${FUTILITY}" update -a "${A}" --manifest -j 4 >"${TMP_JSON_OUT}.j4"
+cmp "${TMP_JSON_OUT}" "${TMP_JSON_OUT}.j4"
+
+echo "TEST: Manifest parseable (--parseable-manifest, -a, unified build, -j 4)"
+"${FUTILITY}" update -a "${A}" --parseable-manifest >"${TMP_PARSEABLE_OUT}"
+"${FUTILITY}" update -a "${A}" --parseable-manifest -j 4 \
+  >"${TMP_PARSEABLE_OUT}.j4"
+cmp "${TMP_PARSEABLE_OUT}" "${TMP_PARSEABLE_OUT}.j4"
+
 cp -f "${PEPPY_BIOS}" "${FROM_IMAGE}.ap"
 cp -f "${LINK_BIOS}" "${FROM_IMAGE}.al"
 cp -f "${VOXEL_BIOS}" "${FROM_IMAGE}.av"
@@ -737,6 +818,15 @@ test_cbfstool() {
     -i "${TO_IMAGE}" --wp=0 \
     --quirks eve_smm_store
 
+  # RW_LEGACY is optional for a partial read, but the quirk needs it.
+  cp -f "${EXPECTED}/rw" "${EXPECTED}/rw_smm"
+  cbfstool "${EXPECTED}/rw_smm" add -r RW_LEGACY -n "smm_store" \
+    -f "${smm}" -t raw -b 0x1bf000
+  test_update_reads "Partial read (RW update, --quirks eve_smm_store)" \
+    "${TMP_FROM}.smm" "${EXPECTED}/rw_smm" "RW_LEGACY !RO_SECTION" \
+    -i "${TO_IMAGE}" --wp=1 \
+    --quirks eve_smm_store
+
   echo "min_platform_version=3" >"${quirk}"
   cp -f "${TO_IMAGE}" "${TO_IMAGE}.quirk"
   "${FUTILITY}" dump_fmap -x "${TO_IMAGE}" "BOOT_STUB:${cbfs}"
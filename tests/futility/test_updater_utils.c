@@ -8,6 +8,7 @@
 
 #define IMAGE_MAIN	 GET_WORK_COPY_TEST_DATA_FILE_PATH("image.bin")
 #define ARCHIVE		 GET_WORK_COPY_TEST_DATA_FILE_PATH("images.zip")
+#define ARCHIVE_TAR	 GET_WORK_COPY_TEST_DATA_FILE_PATH("dup.tar")
 #define FILE_NONEXISTENT GET_WORK_COPY_TEST_DATA_FILE_PATH("nonexistent")
 #define FILE_READONLY	 GET_WORK_COPY_TEST_DATA_FILE_PATH("read-only")
 /* When a custom image needs to be created, it will be written to this file. It also acts as a
@@ -182,6 +183,34 @@ unit_cleanup:
 	UNIT_TEST_RETURN;
 }
 
+/* A file appended to a tar again replaces the earlier copy. */
+static enum unit_result test_archive_duplicate_entry(void)
+{
+	UNIT_TEST_BEGIN;
+#ifdef HAVE_LIBARCHIVE
+	struct u_archive *archive = NULL;
+	uint8_t *data = NULL;
+	uint32_t size = 0;
+
+	UNIT_ASSERT(system("cd " WORK_COPY_TEST_DATA_DIR " && "
+			   "echo old >dup.txt && tar -cf dup.tar dup.txt && "
+			   "echo new >dup.txt && tar -rf dup.tar dup.txt") == 0);
+	archive = archive_open(ARCHIVE_TAR);
+	UNIT_ASSERT(archive != NULL);
+
+	TEST_EQ(archive_read_file(archive, "dup.txt", &data, &size, NULL), 0,
+		"Read duplicate entry from tar");
+	TEST_EQ(size, 4, "Verifying size");
+	TEST_EQ(data && !memcmp(data, "new\n", 4), 1, "Last duplicate entry is read");
+
+unit_cleanup:
+	if (archive)
+		archive_close(archive);
+	free(data);
+#endif
+	UNIT_TEST_RETURN;
+}
+
 static enum unit_result test_parse_firmware_image(void)
 {
 	UNIT_TEST_BEGIN;
@@ -607,6 +636,7 @@ int main(int argc, char *argv[])
 
 	test_temp_file();
 	test_load_firmware_image();
+	test_archive_duplicate_entry();
 	test_parse_firmware_image();
 	test_firmware_version();
 	test_reload_firmware_image();
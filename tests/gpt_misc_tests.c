@@ -9,6 +9,7 @@
 #include "cgptlib.h"
 #include "cgptlib_internal.h"
 #include "common/tests.h"
+#include "crc32.h"
 #include "gpt.h"
 #include "vboot_api.h"
 
@@ -29,6 +30,7 @@ struct mock_part {
 static char call_log[4096];
 static int disk_read_to_fail;
 static int disk_write_to_fail;
+static int disk_sectors_written;
 
 static vb2ex_disk_handle_t handle;
 static uint8_t mock_disk[MOCK_SECTOR_SIZE * MOCK_SECTOR_COUNT];
@@ -88,6 +90,7 @@ static void ResetMocks(void)
 
 	disk_read_to_fail = -1;
 	disk_write_to_fail = -1;
+	disk_sectors_written = 0;
 }
 
 /* Mocks */
@@ -116,6 +119,7 @@ vb2_error_t VbExDiskWrite(vb2ex_disk_handle_t h, uint64_t lba_start,
 
 	memcpy(&mock_disk[lba_start * MOCK_SECTOR_SIZE], buffer,
 	       lba_count * MOCK_SECTOR_SIZE);
+	disk_sectors_written += lba_count;
 
 	return VB2_SUCCESS;
 }
@@ -371,9 +375,142 @@ static void ReadWriteGptTest(void)
 
 }
 
+/**
+ * Add kernel entries to both copies of the mock GPT and fix up the CRCs, so
+ * the GPT is valid and both copies match.
+ */
+static void SetupKernelEntries(const int *index, int count)
+{
+	GptEntry *entries1 = (GptEntry *)&mock_disk[MOCK_SECTOR_SIZE *
+		mock_gpt_primary->entries_lba];
+	GptEntry *entries2 = (GptEntry *)&mock_disk[MOCK_SECTOR_SIZE *
+		mock_gpt_secondary->entries_lba];
+	uint32_t entries_size = MAX_NUMBER_OF_ENTRIES * sizeof(GptEntry);
+	int i;
+
+	for (i = 0; i < count; i++) {
+		GptEntry *e = entries1 + index[i];
+
+		memcpy(&e->type, &guid_chromeos_kernel, sizeof(Guid));
+		e->unique.u.raw[0] = i + 1;
+		e->starting_lba = 100 + 100 * i;
+		e->ending_lba = e->starting_lba + 99;
+		SetEntryPriority(e, 2);
+		SetEntryTries(e, 3);
+	}
+	memcpy(entries2, entries1, entries_size);
+
+	mock_gpt_primary->entries_crc32 = Crc32(entries1, entries_size);
+	mock_gpt_primary->header_crc32 = HeaderCrc(mock_gpt_primary);
+	mock_gpt_secondary->entries_crc32 = mock_gpt_primary->entries_crc32;
+	mock_gpt_secondary->header_crc32 = HeaderCrc(mock_gpt_secondary);
+}
+
+/**
+ * Read the mock GPT back and check it's still valid, with matching copies.
+ */
+static void CheckWrittenGpt(const char *desc)
+{
+	GptData g;
+
+	g.sector_bytes = MOCK_SECTOR_SIZE;
+	g.streaming_drive_sectors = g.gpt_drive_sectors = MOCK_SECTOR_COUNT;
+	g.flags = 0;
+	TEST_EQ(AllocAndReadGptData(handle, &g), 0, desc);
+	TEST_EQ(GptValidityCheck(&g), GPT_SUCCESS, "  valid");
+	TEST_EQ(g.valid_headers, MASK_BOTH, "  both headers");
+	TEST_EQ(g.valid_entries, MASK_BOTH, "  both entry tables");
+	g.modified = 0;
+	WriteAndFreeGptData(handle, &g);
+}
+
+/**
+ * Test how much of the GPT gets written back for common updates
+ */
+static void PartialWriteGptTest(void)
+{
+	static const int one_kernel[] = {5};
+	static const int two_kernels[] = {2, 9};
+	GptData g;
+	GptEntry *entries;
+
+	g.sector_bytes = MOCK_SECTOR_SIZE;
+	g.streaming_drive_sectors = g.gpt_drive_sectors = MOCK_SECTOR_COUNT;
+	g.flags = 0;
+
+	/* Using up a try rewrites the headers and the sector with the entry */
+	ResetMocks();
+	SetupKernelEntries(one_kernel, 1);
+	TEST_EQ(AllocAndReadGptData(handle, &g), 0, "Try: AllocAndRead");
+	TEST_EQ(GptInit(&g), GPT_SUCCESS, "Try: GptInit");
+	entries = (GptEntry *)g.primary_entries;
+	TEST_EQ(GptUpdateKernelWithEntry(&g, entries + 5, GPT_UPDATE_ENTRY_TRY),
+		GPT_SUCCESS, "Try: update");
+	TEST_EQ(GetEntryTries(entries + 5), 2, "Try: tries used");
+	ResetCallLog();
+	TEST_EQ(WriteAndFreeGptData(handle, &g), 0, "Try: WriteAndFree");
+	TEST_CALLS("VbExDiskWrite(h, 1, 1)\n"
+		   "VbExDiskWrite(h, 3, 1)\n"
+		   "VbExDiskWrite(h, 1023, 1)\n"
+		   "VbExDiskWrite(h, 992, 1)\n");
+	TEST_EQ(disk_sectors_written, 4, "Try: sectors written");
+	CheckWrittenGpt("Try: reread");
+
+	/* Marking a kernel bad is no different */
+	ResetMocks();
+	SetupKernelEntries(one_kernel, 1);
+	AllocAndReadGptData(handle, &g);
+	GptInit(&g);
+	entries = (GptEntry *)g.primary_entries;
+	TEST_EQ(GptUpdateKernelWithEntry(&g, entries + 5, GPT_UPDATE_ENTRY_BAD),
+		GPT_SUCCESS, "Bad: update");
+	TEST_EQ(WriteAndFreeGptData(handle, &g), 0, "Bad: WriteAndFree");
+	TEST_EQ(disk_sectors_written, 4, "Bad: sectors written");
+	CheckWrittenGpt("Bad: reread");
+
+	/* Updating two kernels writes the sectors spanning both */
+	ResetMocks();
+	SetupKernelEntries(two_kernels, 2);
+	AllocAndReadGptData(handle, &g);
+	GptInit(&g);
+	entries = (GptEntry *)g.primary_entries;
+	TEST_EQ(GptUpdateKernelWithEntry(&g, entries + 9, GPT_UPDATE_ENTRY_TRY),
+		GPT_SUCCESS, "Two: update first");
+	TEST_EQ(GptUpdateKernelWithEntry(&g, entries + 2,
+					 GPT_UPDATE_ENTRY_ACTIVE),
+		GPT_SUCCESS, "Two: update second");
+	ResetCallLog();
+	TEST_EQ(WriteAndFreeGptData(handle, &g), 0, "Two: WriteAndFree");
+	TEST_CALLS("VbExDiskWrite(h, 1, 1)\n"
+		   "VbExDiskWrite(h, 2, 3)\n"
+		   "VbExDiskWrite(h, 1023, 1)\n"
+		   "VbExDiskWrite(h, 991, 3)\n");
+	TEST_EQ(disk_sectors_written, 8, "Two: sectors written");
+	CheckWrittenGpt("Two: reread");
+
+	/* Repairing a copy still rewrites all of it */
+	ResetMocks();
+	SetupKernelEntries(one_kernel, 1);
+	mock_disk[MOCK_SECTOR_SIZE * 995] ^= 0xff;
+	AllocAndReadGptData(handle, &g);
+	TEST_EQ(GptInit(&g), GPT_SUCCESS, "Repair: GptInit");
+	entries = (GptEntry *)g.primary_entries;
+	TEST_EQ(GptUpdateKernelWithEntry(&g, entries + 5, GPT_UPDATE_ENTRY_TRY),
+		GPT_SUCCESS, "Repair: update");
+	ResetCallLog();
+	TEST_EQ(WriteAndFreeGptData(handle, &g), 0, "Repair: WriteAndFree");
+	TEST_CALLS("VbExDiskWrite(h, 1, 1)\n"
+		   "VbExDiskWrite(h, 2, 32)\n"
+		   "VbExDiskWrite(h, 1023, 1)\n"
+		   "VbExDiskWrite(h, 991, 32)\n");
+	TEST_EQ(disk_sectors_written, 66, "Repair: sectors written");
+	CheckWrittenGpt("Repair: reread");
+}
+
 int main(void)
 {
 	ReadWriteGptTest();
+	PartialWriteGptTest();
 
 	return gTestSuccess ? 0 : 255;
 }
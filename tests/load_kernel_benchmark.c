@@ -0,0 +1,548 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Benchmark vb2api_load_kernel() against a disk image, behind a simulated
+ * block device with configurable per-request latency and bandwidth.
+ *
+ * The device runs on a virtual clock: CPU work advances it in real time, and
+ * waiting for a transfer advances it by however long the simulated device
+ * would still take.  So slow devices cost no wall time, results are repeatable,
+ * and asynchronous reads overlap with hashing exactly as far as the firmware
+ * lets them.
+ *
+ * vb2ex_mtime() returns virtual microseconds rather than milliseconds, so the
+ * boot phase records in vb2_shared_data have useful resolution.  Results go
+ * to stdout as "<name>_median_ns:<value>" and "<name>_p99_ns:<value>" lines.
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "2api.h"
+#include "2common.h"
+#include "2misc.h"
+#include "2struct.h"
+#include "2sysincludes.h"
+#include "common/benchmark.h"
+#include "host_misc.h"
+#include "vboot_api.h"
+
+#define LBA_BYTES 512
+#define KERNEL_BUFFER_SIZE (64 * 1024 * 1024)
+#define DEFAULT_ITERATIONS 10
+
+struct device_profile {
+	const char *name;
+	/* Fixed cost of each request */
+	uint64_t latency_ns;
+	/* Transfer rate; 0 for unlimited */
+	uint64_t mbytes_per_sec;
+};
+
+/* Rough figures for typical boot devices */
+static const struct device_profile profiles[] = {
+	{ "ram", 0, 0 },
+	{ "emmc", 100 * 1000, 250 },
+	{ "ufs", 60 * 1000, 1000 },
+	{ "nvme", 20 * 1000, 2500 },
+	{ "usb", 500 * 1000, 35 },
+};
+
+enum read_kind {
+	READ_GPT,
+	READ_VBLOCK,
+	READ_BODY,
+	READ_KIND_COUNT
+};
+
+/* The disk image */
+static const uint8_t *disk_data;
+static uint64_t disk_size;
+
+/* Simulated device state */
+static const struct device_profile *profile;
+static bool async_reads;
+/* Virtual time added by waiting on the device */
+static uint64_t wait_ns;
+/* Virtual time at which the device finishes its queued requests */
+static uint64_t device_idle_ns;
+static uint64_t read_wait_ns[READ_KIND_COUNT];
+static uint64_t read_bytes[READ_KIND_COUNT];
+
+static uint64_t virtual_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec + wait_ns;
+}
+
+/* Queue a transfer, returning the virtual time it completes. */
+static uint64_t device_submit(uint64_t bytes, enum read_kind kind)
+{
+	uint64_t start = VB2_MAX(virtual_ns(), device_idle_ns);
+
+	device_idle_ns = start + profile->latency_ns;
+	if (profile->mbytes_per_sec)
+		device_idle_ns += bytes * 1000 / profile->mbytes_per_sec;
+	read_bytes[kind] += bytes;
+
+	return device_idle_ns;
+}
+
+static void device_wait(uint64_t done_ns, enum read_kind kind)
+{
+	uint64_t now = virtual_ns();
+
+	if (done_ns > now) {
+		wait_ns += done_ns - now;
+		read_wait_ns[kind] += done_ns - now;
+	}
+}
+
+static vb2_error_t disk_copy(uint64_t offset, uint64_t bytes, void *buffer)
+{
+	if (offset > disk_size || bytes > disk_size - offset) {
+		fprintf(stderr, "Read overrun: %" PRIu64 " + %" PRIu64
+			" > %" PRIu64 "\n", offset, bytes, disk_size);
+		return VB2_ERROR_UNKNOWN;
+	}
+	memcpy(buffer, disk_data + offset, bytes);
+	return VB2_SUCCESS;
+}
+
+uint32_t vb2ex_mtime(void)
+{
+	return (uint32_t)(virtual_ns() / 1000);
+}
+
+vb2_error_t VbExDiskRead(vb2ex_disk_handle_t handle, uint64_t lba_start,
+			 uint64_t lba_count, void *buffer)
+{
+	uint64_t bytes = lba_count * LBA_BYTES;
+
+	/* Only the GPT is read outside a stream */
+	device_wait(device_submit(bytes, READ_GPT), READ_GPT);
+	return disk_copy(lba_start * LBA_BYTES, bytes, buffer);
+}
+
+vb2_error_t VbExDiskWrite(vb2ex_disk_handle_t handle, uint64_t lba_start,
+			  uint64_t lba_count, const void *buffer)
+{
+	/* Leave the image alone, so every iteration boots the same way */
+	return VB2_SUCCESS;
+}
+
+struct sim_request {
+	uint64_t offset;
+	uint32_t bytes;
+	void *buffer;
+	uint64_t done_ns;
+	enum read_kind kind;
+};
+
+struct sim_stream {
+	uint64_t offset;
+	uint64_t bytes_left;
+	uint32_t reads;
+	struct sim_request pending[VB2_STREAM_ASYNC_DEPTH];
+	uint32_t pending_count;
+};
+
+vb2_error_t VbExStreamOpen(vb2ex_disk_handle_t handle, uint64_t lba_start,
+			   uint64_t lba_count, VbExStream_t *stream)
+{
+	struct sim_stream *s = calloc(1, sizeof(*s));
+
+	if (!s)
+		return VB2_ERROR_UNKNOWN;
+	s->offset = lba_start * LBA_BYTES;
+	s->bytes_left = lba_count * LBA_BYTES;
+	*stream = s;
+	return VB2_SUCCESS;
+}
+
+/* Take the next bytes off the stream for a read request. */
+static vb2_error_t stream_take(struct sim_stream *s, uint32_t bytes,
+			       void *buffer, struct sim_request *req)
+{
+	if (bytes > s->bytes_left)
+		return VB2_ERROR_UNKNOWN;
+
+	req->offset = s->offset;
+	req->bytes = bytes;
+	req->buffer = buffer;
+	/* Load kernel reads the vblock first, then the body */
+	req->kind = s->reads++ ? READ_BODY : READ_VBLOCK;
+	req->done_ns = device_submit(bytes, req->kind);
+
+	s->offset += bytes;
+	s->bytes_left -= bytes;
+	return VB2_SUCCESS;
+}
+
+vb2_error_t VbExStreamSkip(VbExStream_t stream, uint32_t bytes)
+{
+	struct sim_stream *s = stream;
+
+	if (bytes > s->bytes_left)
+		return VB2_ERROR_UNKNOWN;
+	s->offset += bytes;
+	s->bytes_left -= bytes;
+	return VB2_SUCCESS;
+}
+
+vb2_error_t VbExStreamRead(VbExStream_t stream, uint32_t bytes, void *buffer)
+{
+	struct sim_request req;
+
+	VB2_TRY(stream_take(stream, bytes, buffer, &req));
+	device_wait(req.done_ns, req.kind);
+	return disk_copy(req.offset, req.bytes, req.buffer);
+}
+
+vb2_error_t VbExStreamReadAsync(VbExStream_t stream, uint32_t bytes,
+				void *buffer)
+{
+	struct sim_stream *s = stream;
+
+	if (!async_reads)
+		return VB2_ERROR_EX_UNIMPLEMENTED;
+	if (s->pending_count >= VB2_STREAM_ASYNC_DEPTH)
+		return VB2_ERROR_UNKNOWN;
+
+	return stream_take(s, bytes, buffer, &s->pending[s->pending_count++]);
+}
+
+vb2_error_t VbExStreamWaitAsync(VbExStream_t stream)
+{
+	struct sim_stream *s = stream;
+	struct sim_request req;
+	uint32_t i;
+
+	if (!s->pending_count)
+		return VB2_ERROR_UNKNOWN;
+
+	req = s->pending[0];
+	for (i = 1; i < s->pending_count; i++)
+		s->pending[i - 1] = s->pending[i];
+	s->pending_count--;
+
+	device_wait(req.done_ns, req.kind);
+	return disk_copy(req.offset, req.bytes, req.buffer);
+}
+
+void VbExStreamClose(VbExStream_t stream)
+{
+	free(stream);
+}
+
+/*****************************************************************************/
+
+enum metric {
+	METRIC_TOTAL,
+	METRIC_GPT,
+	METRIC_VBLOCK_VERIFY,
+	METRIC_BODY_READ,
+	METRIC_BODY_HASH,
+	METRIC_BODY_VERIFY,
+	METRIC_COUNT
+};
+
+static const char *const metric_names[METRIC_COUNT] = {
+	"total", "gpt", "vblock_verify", "body_read", "body_hash",
+	"body_verify",
+};
+
+static struct vb2_packed_key *kernel_key;
+static uint8_t workbuf[VB2_KERNEL_WORKBUF_RECOMMENDED_SIZE]
+	__attribute__((aligned(VB2_WORKBUF_ALIGN)));
+static uint8_t *kernel_buffer;
+
+/* Boot the image once, filling in the time spent on each metric. */
+static vb2_error_t load_once(uint64_t *ns, uint64_t *bytes,
+			     struct vb2_boot_timing *timing)
+{
+	struct vb2_context *ctx;
+	struct vb2_shared_data *sd;
+	struct vb2_kernel_params params = {
+		.kernel_buffer = kernel_buffer,
+		.kernel_buffer_size = KERNEL_BUFFER_SIZE,
+	};
+	struct vb2_disk_info disk_info = {
+		.handle = (vb2ex_disk_handle_t)&disk_data,
+		.bytes_per_lba = LBA_BYTES,
+		.lba_count = disk_size / LBA_BYTES,
+		.streaming_lba_count = disk_size / LBA_BYTES,
+	};
+	struct vb2_workbuf wb;
+	struct vb2_packed_key *dst;
+	uint32_t key_size = kernel_key->key_offset + kernel_key->key_size;
+	uint64_t start;
+	vb2_error_t rv;
+	int i;
+
+	if (vb2api_init(workbuf, sizeof(workbuf), &ctx)) {
+		fprintf(stderr, "Can't initialize workbuf\n");
+		return VB2_ERROR_UNKNOWN;
+	}
+	sd = vb2_get_sd(ctx);
+
+	/* Normal mode boot with the kernel subkey */
+	vb2_workbuf_from_ctx(ctx, &wb);
+	dst = vb2_workbuf_alloc(&wb, key_size);
+	memcpy(dst, kernel_key, key_size);
+	vb2_set_workbuf_used(ctx, vb2_offset_of(sd, wb.buf));
+	sd->kernel_key_offset = vb2_offset_of(sd, dst);
+	sd->kernel_key_size = key_size;
+
+	device_idle_ns = 0;
+	memset(read_wait_ns, 0, sizeof(read_wait_ns));
+	memset(read_bytes, 0, sizeof(read_bytes));
+
+	start = virtual_ns();
+	rv = vb2api_load_kernel(ctx, &params, &disk_info);
+	ns[METRIC_TOTAL] = virtual_ns() - start;
+
+	*timing = sd->timing;
+	ns[METRIC_GPT] = timing->phase[VB2_TIMING_GPT_LOAD].elapsed_ms;
+	ns[METRIC_VBLOCK_VERIFY] =
+		timing->phase[VB2_TIMING_KEYBLOCK_VERIFY].elapsed_ms +
+		timing->phase[VB2_TIMING_PREAMBLE_VERIFY].elapsed_ms;
+	ns[METRIC_BODY_HASH] = timing->phase[VB2_TIMING_BODY_HASH].elapsed_ms;
+	ns[METRIC_BODY_VERIFY] = timing->phase[VB2_TIMING_RSA].elapsed_ms;
+	/* Phase records are in microseconds, see vb2ex_mtime() */
+	for (i = 0; i < METRIC_COUNT; i++) {
+		if (i != METRIC_TOTAL)
+			ns[i] *= 1000;
+	}
+	/* Only the device time which wasn't hidden behind hashing */
+	ns[METRIC_BODY_READ] = read_wait_ns[READ_BODY];
+
+	bytes[METRIC_TOTAL] = read_bytes[READ_GPT] + read_bytes[READ_VBLOCK] +
+		read_bytes[READ_BODY];
+	bytes[METRIC_GPT] = timing->phase[VB2_TIMING_GPT_LOAD].bytes;
+	bytes[METRIC_VBLOCK_VERIFY] = 0;
+	bytes[METRIC_BODY_READ] = read_bytes[READ_BODY];
+	bytes[METRIC_BODY_HASH] = timing->phase[VB2_TIMING_BODY_HASH].bytes;
+	bytes[METRIC_BODY_VERIFY] = 0;
+
+	return rv;
+}
+
+static int bench_profile(int iterations)
+{
+	struct vb2_boot_timing timing = {0};
+	struct benchmark_result result;
+	uint64_t *samples[METRIC_COUNT];
+	uint64_t ns[METRIC_COUNT], bytes[METRIC_COUNT];
+	const char *mode = async_reads ? "async" : "sync";
+	char name[128];
+	vb2_error_t rv;
+	int ret = 0;
+	int i, m;
+
+	for (m = 0; m < METRIC_COUNT; m++)
+		samples[m] = malloc(iterations * sizeof(uint64_t));
+
+	for (i = 0; i < iterations; i++) {
+		rv = load_once(ns, bytes, &timing);
+		if (rv) {
+			fprintf(stderr, "%s %s: vb2api_load_kernel() returned "
+				"%#x\n", profile->name, mode, rv);
+			ret = 1;
+			goto out;
+		}
+		for (m = 0; m < METRIC_COUNT; m++)
+			samples[m][i] = ns[m];
+	}
+
+	/* Describe the partitions tried on the last boot */
+	for (i = 0; i < timing.kernel_try_count &&
+		    i < VB2_TIMING_MAX_KERNEL_TRIES; i++)
+		fprintf(stderr, "# %s %s: partition %u read %u bytes in %u us, "
+			"result %#x\n", profile->name, mode,
+			timing.kernel_try[i].partition,
+			timing.kernel_try[i].bytes,
+			timing.kernel_try[i].elapsed_ms,
+			timing.kernel_try[i].result);
+
+	for (m = 0; m < METRIC_COUNT; m++) {
+		snprintf(name, sizeof(name), "load_kernel_%s_%s_%s",
+			 profile->name, mode, metric_names[m]);
+		benchmark_summarize(samples[m], iterations, &result);
+		benchmark_report(name, &result, bytes[m]);
+	}
+
+out:
+	for (m = 0; m < METRIC_COUNT; m++)
+		free(samples[m]);
+	return ret;
+}
+
+static int map_image(const char *filename)
+{
+	struct stat st;
+	void *data;
+	int fd;
+
+	fd = open(filename, O_RDONLY);
+	if (fd < 0 || fstat(fd, &st)) {
+		fprintf(stderr, "Unable to open image file %s\n", filename);
+		if (fd >= 0)
+			close(fd);
+		return 1;
+	}
+
+	/* Fault the whole image in now, so page faults aren't timed */
+	data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE | MAP_POPULATE,
+		    fd, 0);
+	close(fd);
+	if (data == MAP_FAILED) {
+		fprintf(stderr, "Unable to map image file %s\n", filename);
+		return 1;
+	}
+
+	disk_data = data;
+	disk_size = st.st_size;
+	return 0;
+}
+
+static void print_usage(const char *progname)
+{
+	int i;
+
+	fprintf(stderr,
+		"usage: %s [options] <drive_image> <kernel_subkey.vbpubk>\n"
+		"\noptions:\n"
+		"  -p NAME    device profile (default all):",
+		progname);
+	for (i = 0; i < ARRAY_SIZE(profiles); i++)
+		fprintf(stderr, " %s", profiles[i].name);
+	fprintf(stderr,
+		"\n"
+		"  -l USECS   custom profile request latency\n"
+		"  -b MBPS    custom profile bandwidth in Mbytes/sec\n"
+		"  -m MODE    stream reads: sync, async (default both)\n"
+		"  -n NUM     iterations (default %d)\n", DEFAULT_ITERATIONS);
+}
+
+int main(int argc, char *argv[])
+{
+	struct device_profile custom = { "custom", 0, 0 };
+	const char *profile_name = NULL;
+	const char *mode = NULL;
+	int iterations = DEFAULT_ITERATIONS;
+	int use_custom = 0;
+	uint64_t key_file_size;
+	int c, i, errorcnt = 0;
+	int ret = 0;
+	char *e = NULL;
+
+	opterr = 0;
+	while ((c = getopt(argc, argv, ":p:l:b:m:n:")) != -1) {
+		switch (c) {
+		case 'p':
+			profile_name = optarg;
+			break;
+		case 'l':
+			custom.latency_ns = strtoull(optarg, &e, 0) * 1000;
+			use_custom = 1;
+			break;
+		case 'b':
+			custom.mbytes_per_sec = strtoull(optarg, &e, 0);
+			use_custom = 1;
+			break;
+		case 'm':
+			mode = optarg;
+			if (strcmp(mode, "sync") && strcmp(mode, "async")) {
+				fprintf(stderr, "Unknown mode %s\n", mode);
+				errorcnt++;
+			}
+			break;
+		case 'n':
+			iterations = strtol(optarg, &e, 0);
+			if (iterations < 1)
+				errorcnt++;
+			break;
+		case '?':
+			fprintf(stderr, "Unrecognized switch: -%c\n", optopt);
+			errorcnt++;
+			break;
+		case ':':
+			fprintf(stderr, "Missing argument to -%c\n", optopt);
+			errorcnt++;
+			break;
+		default:
+			errorcnt++;
+			break;
+		}
+		if (e && *e) {
+			fprintf(stderr, "Invalid argument to -%c: \"%s\"\n",
+				c, optarg);
+			errorcnt++;
+		}
+		e = NULL;
+	}
+
+	if (errorcnt || argc - optind != 2) {
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	if (map_image(argv[optind]))
+		return 1;
+
+	kernel_key = (struct vb2_packed_key *)ReadFile(argv[optind + 1],
+						       &key_file_size);
+	if (!kernel_key || key_file_size < sizeof(*kernel_key) ||
+	    vb2_verify_packed_key_inside(kernel_key, key_file_size,
+					 kernel_key)) {
+		fprintf(stderr, "Unable to read key file %s\n",
+			argv[optind + 1]);
+		return 1;
+	}
+
+	kernel_buffer = malloc(KERNEL_BUFFER_SIZE);
+	if (!kernel_buffer) {
+		fprintf(stderr, "Unable to allocate kernel buffer.\n");
+		return 1;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(profiles) + 1; i++) {
+		if (i < ARRAY_SIZE(profiles)) {
+			if (use_custom || (profile_name &&
+			    strcmp(profile_name, profiles[i].name)))
+				continue;
+			profile = &profiles[i];
+		} else {
+			if (!use_custom)
+				continue;
+			profile = &custom;
+		}
+
+		if (!mode || !strcmp(mode, "sync")) {
+			async_reads = false;
+			ret |= bench_profile(iterations);
+		}
+		if (!mode || !strcmp(mode, "async")) {
+			async_reads = true;
+			ret |= bench_profile(iterations);
+		}
+	}
+
+	if (!profile) {
+		fprintf(stderr, "Unknown profile %s\n", profile_name);
+		ret = 1;
+	}
+
+	free(kernel_buffer);
+	free(kernel_key);
+	return ret;
+}
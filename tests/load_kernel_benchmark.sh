@@ -0,0 +1,59 @@
+#!/bin/bash
+
+# Copyright 2026 The ChromiumOS Authors
+# Use of this source code is governed by a BSD-style license that can be
+# found in the LICENSE file.
+#
+# Benchmark vb2api_load_kernel() on a multi-partition disk image.  Any
+# arguments are passed on to load_kernel_benchmark (e.g. "-p emmc").
+
+# Load common constants and variables.
+. "$(dirname "$0")/common.sh"
+
+set -e
+
+CGPT=${BIN_DIR}/cgpt
+
+# Run in a dedicated directory for easy cleanup or debugging.
+DIR="${TEST_DIR}/load_kernel_benchmark_dir"
+[ -d "$DIR" ] || mkdir -p "$DIR"
+echo "Creating benchmark disk image in $DIR" 1>&2
+cd "$DIR"
+
+# Kernel data, about the size of a real kernel
+echo "hi there" > "dummy_config.txt"
+dd if=/dev/urandom bs=16384 count=1 of="dummy_bootloader.bin" 2>/dev/null
+dd if=/dev/urandom bs=1M count=4 of="dummy_kernel.bin" 2>/dev/null
+
+"${FUTILITY}" vbutil_key --pack datakey.test \
+    --key "${TESTKEY_DIR}/key_rsa2048.keyb" --algorithm 4 >/dev/null
+
+# Flags=21 means dev=0 rec=0 minios=0
+"${FUTILITY}" vbutil_keyblock --pack keyblock.test \
+    --datapubkey datakey.test \
+    --flags 21 \
+    --signprivate "${SCRIPT_DIR}/devkeys/kernel_subkey.vbprivk" >/dev/null
+
+"${FUTILITY}" vbutil_kernel \
+    --pack "kernel.test" \
+    --keyblock "keyblock.test" \
+    --signprivate "${TESTKEY_DIR}/key_rsa2048.sha256.vbprivk" \
+    --version 1 \
+    --arch arm \
+    --vmlinuz "dummy_kernel.bin" \
+    --bootloader "dummy_bootloader.bin" \
+    --config "dummy_config.txt" >/dev/null
+
+# Kernel A is tried first, but its body is corrupt, so it is read and hashed
+# in full before kernel B boots.
+dd if=/dev/zero of=disk.test bs=1M count=12 2>/dev/null
+${CGPT} create disk.test
+${CGPT} add -i 1 -S 1 -P 2 -b 2048 -s 10240 -t kernel -l KERN-A disk.test
+${CGPT} add -i 2 -S 1 -P 1 -b 12288 -s 10240 -t kernel -l KERN-B disk.test
+dd if=kernel.test of=disk.test bs=512 seek=2048 conv=notrunc 2>/dev/null
+dd if=kernel.test of=disk.test bs=512 seek=12288 conv=notrunc 2>/dev/null
+dd if=/dev/urandom of=disk.test bs=512 seek=$((2048 + 2048)) count=1 \
+    conv=notrunc 2>/dev/null
+
+"${BUILD_RUN}/tests/load_kernel_benchmark" "$@" disk.test \
+    "${SCRIPT_DIR}/devkeys/kernel_subkey.vbpubk"
@@ -303,6 +303,51 @@ run_prioritize_tests() {
 }
 run_prioritize_tests
 
+echo "Test the cgpt batch command..."
+make_pri 2 0 0
+"${CGPT}" batch "${MTD[@]}" ${DEV} >/dev/null <<EOF
+# Several edits, written out once
+prioritize -i 2
+add -i 3 -P 5 -l "kern three"
+
+edit -u ${RANDOM_DRIVE_GUID}
+boot -i 3
+EOF
+assert_pri 1 2 5
+X=$("${CGPT}" show "${MTD[@]}" -l -i 3 ${DEV})
+[ "$X" = "kern three" ] || error
+X=$("${CGPT}" show "${MTD[@]}" -v ${DEV} | grep -i "disk uuid" | \
+  head -1 | awk ' { print $3 } ' )
+[ "$X" = "${RANDOM_DRIVE_GUID}" ] || error
+X=$("${CGPT}" boot "${MTD[@]}" ${DEV})
+Y=$("${CGPT}" show "${MTD[@]}" -u -i 3 $DEV)
+[ "$X" = "$Y" ] || error
+echo "prioritize -i 1" > batch.txt
+"${CGPT}" batch "${MTD[@]}" -f batch.txt ${DEV}
+assert_pri 3 1 2
+# A failing command leaves the drive untouched
+cp ${DEV} ${DEV}.orig
+printf 'add -i 1 -P 9\nadd -i 2 -b 99999 -s 1\n' > batch.txt
+assert_fail "${CGPT}" batch "${MTD[@]}" -f batch.txt ${DEV}
+cmp -s ${DEV} ${DEV}.orig || error
+assert_fail "${CGPT}" batch "${MTD[@]}" ${DEV} <<< "show"
+assert_fail "${CGPT}" batch "${MTD[@]}" ${DEV} <<< "add -l 'open quote"
+assert_fail "${CGPT}" batch "${MTD[@]}" ${DEV} <<< "add -i 1 -P 9 ${DEV}"
+assert_fail "${CGPT}" batch "${MTD[@]}" ${DEV} <<< "boot -i 1 ${DEV}"
+assert_fail "${CGPT}" batch "${MTD[@]}" ${DEV} <<< "edit -u ${RANDOM_DRIVE_GUID} ${DEV}"
+assert_fail "${CGPT}" batch "${MTD[@]}" ${DEV} <<< "prioritize -i 1 ${DEV}"
+cmp -s ${DEV} ${DEV}.orig || error
+
+echo "Test cgpt find on several drives at once..."
+make_pri 1 2 3
+for i in 1 2 3 4 5; do cp ${DEV} ${DEV}.$i; done
+"${CGPT}" add "${MTD[@]}" -i 2 -t data ${DEV}.3
+X=$("${CGPT}" find "${MTD[@]}" -t kernel ${DEV}.[1-5])
+Y=$("${CGPT}" find "${MTD[@]}" -j 3 -t kernel ${DEV}.[1-5])
+[ "$X" = "$Y" ] || error
+[ "$(echo "$Y" | wc -l)" = 14 ] || error
+[ "$(echo "$Y" | head -4 | tail -1)" = "${DEV}.2p1" ] || error
+
 echo "Test cgpt repair command"
 "${CGPT}" repair "${MTD[@]}" ${DEV}
 ("${CGPT}" show "${MTD[@]}" ${DEV} | grep -q INVALID) && error
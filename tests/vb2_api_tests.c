@@ -247,6 +247,24 @@ vb2_error_t vb2_rsa_verify_digest(const struct vb2_public_key *key,
 	return retval_vb2_verify_digest;
 }
 
+vb2_error_t vb2_rsa_verify_digests(const struct vb2_public_key *key,
+				   uint8_t *const sigs[],
+				   const uint8_t *const digests[],
+				   uint32_t count, vb2_error_t results[],
+				   const struct vb2_workbuf *wb)
+{
+	vb2_error_t rv = VB2_SUCCESS;
+	uint32_t i;
+
+	for (i = 0; i < count; i++) {
+		results[i] = vb2_rsa_verify_digest(key, sigs[i], digests[i],
+						   wb);
+		if (rv == VB2_SUCCESS)
+			rv = results[i];
+	}
+	return rv;
+}
+
 /* Tests */
 static int vb2_try_returned;
 
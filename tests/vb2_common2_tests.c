@@ -11,6 +11,7 @@
 
 #include "2common.h"
 #include "2rsa.h"
+#include "2rsa_private.h"
 #include "2sysincludes.h"
 #include "common/tests.h"
 #include "file_keys.h"
@@ -163,6 +164,46 @@ static void test_unpack_key(const struct vb2_packed_key *key1)
 		"vb2_unpack_key_() buffer NULL");
 }
 
+static void test_modexp(const struct vb2_packed_key *key1,
+			const struct vb2_signature *sig)
+{
+	struct vb2_public_key pubk;
+	uint32_t workbuf[3 * 8192 / 32];
+	uint8_t in[4][8192 / 8], out32[8192 / 8], out[8192 / 8];
+	const int exps[] = { 3, 65537 };
+	uint32_t size;
+	int i, e, mismatch = 0;
+
+	TEST_SUCC(vb2_unpack_key(&pubk, key1), "vb2_modexp() unpack key");
+	size = pubk.arrsize * sizeof(uint32_t);
+
+	/* A real signature, 0, 1, and an input larger than the modulus */
+	memcpy(in[0], vb2_signature_data(sig), size);
+	memset(in[1], 0, size);
+	memset(in[2], 0, size);
+	in[2][size - 1] = 1;
+	memset(in[3], 0xff, size);
+
+	for (e = 0; e < ARRAY_SIZE(exps); e++) {
+		for (i = 0; i < ARRAY_SIZE(in); i++) {
+			memcpy(out32, in[i], size);
+			vb2_modexp32(&pubk, out32, workbuf, exps[e]);
+
+			memcpy(out, in[i], size);
+			vb2_modexp(&pubk, out, workbuf, exps[e]);
+			if (memcmp(out, out32, size))
+				mismatch++;
+#ifdef VB2_MODEXP64
+			memcpy(out, in[i], size);
+			vb2_modexp64(&pubk, out, exps[e]);
+			if (memcmp(out, out32, size))
+				mismatch++;
+#endif
+		}
+	}
+	TEST_EQ(mismatch, 0, "vb2_modexp() matches 32-bit implementation");
+}
+
 static void test_verify_data(const struct vb2_packed_key *key1,
 			     const struct vb2_signature *sig)
 {
@@ -290,6 +331,137 @@ static void test_verify_data(const struct vb2_packed_key *key1,
 }
 
 
+static void test_verify_digests(const struct vb2_packed_key *key1,
+				const struct vb2_signature *sig)
+{
+	uint8_t workbuf[VB2_VERIFY_DATA_WORKBUF_BYTES + 64]
+		 __attribute__((aligned(VB2_WORKBUF_ALIGN)));
+	struct vb2_workbuf wb;
+	struct vb2_public_key pubk;
+	enum vb2_signature_algorithm orig_sig_alg;
+	uint32_t sig_total_size = sig->sig_offset + sig->sig_size;
+	struct vb2_signature *sigs[5];
+	uint8_t *sig_data[5];
+	const uint8_t *digests[5];
+	vb2_error_t results[5];
+	vb2_error_t rv;
+	struct vb2_hash hash;
+	int i;
+
+	hwcrypto_state_rsa = HWCRYPTO_ABORT;
+	hwcrypto_state_digest = HWCRYPTO_ABORT;
+
+	vb2_workbuf_init(&wb, workbuf, sizeof(workbuf));
+	TEST_SUCC(vb2_unpack_key(&pubk, key1),
+		  "vb2_verify_digests() unpack key");
+	TEST_SUCC(vb2_hash_calculate(false, test_data, test_size,
+				     pubk.hash_alg, &hash),
+		  "vb2_verify_digests() hash");
+
+	for (i = 0; i < ARRAY_SIZE(sigs); i++) {
+		sigs[i] = malloc(sig_total_size);
+		digests[i] = hash.raw;
+	}
+
+#define RESET_SIGS()							\
+	for (i = 0; i < ARRAY_SIZE(sigs); i++) {			\
+		memcpy(sigs[i], sig, sig_total_size);			\
+		sig_data[i] = vb2_signature_data_mutable(sigs[i]);	\
+		results[i] = VB2_ERROR_MOCK;				\
+	}
+
+	RESET_SIGS();
+	TEST_SUCC(vb2_verify_digests(&pubk, sigs, digests, ARRAY_SIZE(sigs),
+				     results, &wb),
+		  "vb2_verify_digests() all good");
+	for (i = 0; i < ARRAY_SIZE(sigs); i++)
+		TEST_SUCC(results[i], "  result");
+
+	RESET_SIGS();
+	vb2_signature_data_mutable(sigs[1])[0] ^= 0x5A;
+	sigs[3]->sig_size -= 16;
+	rv = vb2_verify_digests(&pubk, sigs, digests, ARRAY_SIZE(sigs),
+				results, &wb);
+	TEST_EQ(rv, results[1], "vb2_verify_digests() returns first error");
+	TEST_SUCC(results[0], "  good sig");
+	TEST_NEQ(results[1], VB2_SUCCESS, "  bad sig");
+	TEST_SUCC(results[2], "  good sig");
+	TEST_EQ(results[3], VB2_ERROR_VDATA_SIG_SIZE, "  bad sig size");
+	TEST_SUCC(results[4], "  good sig");
+
+	RESET_SIGS();
+	pubk.allow_hwcrypto = 1;
+	hwcrypto_state_rsa = HWCRYPTO_NOTSUPPORTED;
+	vb2_signature_data_mutable(sigs[2])[0] ^= 0x5A;
+	TEST_NEQ(vb2_verify_digests(&pubk, sigs, digests, ARRAY_SIZE(sigs),
+				    results, &wb),
+		 VB2_SUCCESS, "vb2_verify_digests() hwcrypto fallback");
+	TEST_SUCC(results[1], "  good sig");
+	TEST_NEQ(results[2], VB2_SUCCESS, "  bad sig");
+	pubk.allow_hwcrypto = 0;
+	hwcrypto_state_rsa = HWCRYPTO_ABORT;
+
+	RESET_SIGS();
+	vb2_workbuf_init(&wb, workbuf, 4);
+	TEST_EQ(vb2_verify_digests(&pubk, sigs, digests, ARRAY_SIZE(sigs),
+				   results, &wb),
+		VB2_ERROR_WORKBUF_SMALL,
+		"vb2_verify_digests() workbuf too small");
+	vb2_workbuf_init(&wb, workbuf, sizeof(workbuf));
+
+	/* vb2_rsa_verify_digests() directly */
+	RESET_SIGS();
+	sig_data[1] = NULL;
+	digests[2] = NULL;
+	sig_data[4][0] ^= 0x5A;
+	TEST_EQ(vb2_rsa_verify_digests(&pubk, sig_data, digests,
+				       ARRAY_SIZE(sigs), results, &wb),
+		VB2_ERROR_RSA_VERIFY_PARAM,
+		"vb2_rsa_verify_digests() NULL entries");
+	TEST_SUCC(results[0], "  good sig");
+	TEST_EQ(results[1], VB2_ERROR_RSA_VERIFY_PARAM, "  NULL sig");
+	TEST_EQ(results[2], VB2_ERROR_RSA_VERIFY_PARAM, "  NULL digest");
+	TEST_SUCC(results[3], "  good sig");
+	TEST_NEQ(results[4], VB2_SUCCESS, "  bad sig");
+	digests[2] = hash.raw;
+
+	RESET_SIGS();
+	TEST_SUCC(vb2_rsa_verify_digests(&pubk, sig_data, digests, 1,
+					 results, &wb),
+		  "vb2_rsa_verify_digests() one sig");
+	TEST_SUCC(vb2_rsa_verify_digests(&pubk, sig_data, digests, 0,
+					 results, &wb),
+		  "vb2_rsa_verify_digests() no sigs");
+
+	RESET_SIGS();
+	orig_sig_alg = pubk.sig_alg;
+	pubk.sig_alg = VB2_SIG_INVALID;
+	TEST_EQ(vb2_rsa_verify_digests(&pubk, sig_data, digests,
+				       ARRAY_SIZE(sigs), results, &wb),
+		VB2_ERROR_RSA_VERIFY_ALGORITHM,
+		"vb2_rsa_verify_digests() bad sig alg");
+	TEST_EQ(results[4], VB2_ERROR_RSA_VERIFY_ALGORITHM, "  result");
+	pubk.sig_alg = orig_sig_alg;
+
+	RESET_SIGS();
+	vb2_workbuf_init(&wb, workbuf, pubk.arrsize * sizeof(uint32_t) * 3 - 1);
+	TEST_EQ(vb2_rsa_verify_digests(&pubk, sig_data, digests,
+				       ARRAY_SIZE(sigs), results, &wb),
+		VB2_ERROR_RSA_VERIFY_WORKBUF,
+		"vb2_rsa_verify_digests() workbuf too small");
+
+	TEST_EQ(vb2_rsa_verify_digests(NULL, sig_data, digests,
+				       ARRAY_SIZE(sigs), results, &wb),
+		VB2_ERROR_RSA_VERIFY_PARAM,
+		"vb2_rsa_verify_digests() NULL key");
+
+#undef RESET_SIGS
+
+	for (i = 0; i < ARRAY_SIZE(sigs); i++)
+		free(sigs[i]);
+}
+
+
 static int test_algorithm(int key_algorithm, const char *keys_dir)
 {
 	char filename[1024];
@@ -328,7 +500,9 @@ static int test_algorithm(int key_algorithm, const char *keys_dir)
 		goto cleanup_algorithm;
 
 	test_unpack_key(key1);
+	test_modexp(key1, sig);
 	test_verify_data(key1, sig);
+	test_verify_digests(key1, sig);
 
 	retval = 0;
 
@@ -0,0 +1,133 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Tests for host library file hashing functions
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "2common.h"
+#include "2sha.h"
+#include "2sysincludes.h"
+#include "common/tests.h"
+#include "file_keys.h"
+#include "host_misc.h"
+
+static void digest_file_tests(const char *temp_dir)
+{
+	/* Empty, smaller than one read chunk, and several chunks plus a bit */
+	const uint32_t sizes[] = { 0, 12345, 3 * 1024 * 1024 + 77 };
+	const enum vb2_hash_algorithm algs[] = {
+		VB2_HASH_SHA1, VB2_HASH_SHA256, VB2_HASH_SHA512,
+	};
+	uint8_t digest[VB2_SHA512_DIGEST_SIZE];
+	struct vb2_hash expect, hash;
+	char *testfile;
+	uint8_t *data;
+	uint32_t i, j, a;
+	int pipefd[2];
+	int fd;
+
+	xasprintf(&testfile, "%s/digest_file_tests.dat", temp_dir);
+
+	for (i = 0; i < ARRAY_SIZE(sizes); i++) {
+		data = malloc(sizes[i] + 1);
+		for (j = 0; j < sizes[i]; j++)
+			data[j] = (uint8_t)(j * 31 + (j >> 11));
+		fd = open(testfile, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		TEST_EQ(write(fd, data, sizes[i]), sizes[i],
+			"write test file");
+		close(fd);
+
+		for (a = 0; a < ARRAY_SIZE(algs); a++) {
+			vb2_hash_calculate(false, data, sizes[i], algs[a],
+					   &expect);
+
+			memset(digest, 0, sizeof(digest));
+			TEST_SUCC(DigestFile(testfile, algs[a], digest,
+					     sizeof(digest)),
+				  "DigestFile()");
+			TEST_EQ(memcmp(digest, expect.raw,
+				       vb2_digest_size(algs[a])), 0,
+				"  digest");
+
+			fd = open(testfile, O_RDONLY);
+			TEST_EQ(vb2_hash_fd_use_thread(fd),
+				sizes[i] > 1024 * 1024, "  reader thread");
+			TEST_SUCC(vb2_hash_fd(fd, algs[a], &hash),
+				  "vb2_hash_fd()");
+			close(fd);
+			TEST_EQ(hash.algo, algs[a], "  algo");
+			TEST_EQ(memcmp(hash.raw, expect.raw,
+				       vb2_digest_size(algs[a])), 0,
+				"  digest");
+		}
+
+		free(data);
+	}
+
+	/* Only what's left after the file offset counts */
+	fd = open(testfile, O_RDONLY);
+	TEST_EQ(lseek(fd, 3 * 1024 * 1024, SEEK_SET), 3 * 1024 * 1024,
+		"seek near the end");
+	TEST_FALSE(vb2_hash_fd_use_thread(fd), "  no reader thread for the rest");
+	TEST_SUCC(vb2_hash_fd(fd, VB2_HASH_SHA256, &hash),
+		  "vb2_hash_fd() from offset");
+	close(fd);
+	data = malloc(77);
+	for (j = 0; j < 77; j++)
+		data[j] = (uint8_t)((3 * 1024 * 1024 + j) * 31 +
+				    ((3 * 1024 * 1024 + j) >> 11));
+	vb2_hash_calculate(false, data, 77, VB2_HASH_SHA256, &expect);
+	TEST_EQ(memcmp(hash.raw, expect.raw, VB2_SHA256_DIGEST_SIZE), 0,
+		"  digest");
+	free(data);
+
+	/* A pipe has no size, so it's read in the calling thread */
+	TEST_EQ(pipe(pipefd), 0, "pipe");
+	TEST_EQ(write(pipefd[1], "abc", 3), 3, "write pipe");
+	close(pipefd[1]);
+	TEST_FALSE(vb2_hash_fd_use_thread(pipefd[0]), "  no reader thread");
+	TEST_SUCC(vb2_hash_fd(pipefd[0], VB2_HASH_SHA256, &hash),
+		  "vb2_hash_fd() pipe");
+	close(pipefd[0]);
+	vb2_hash_calculate(false, "abc", 3, VB2_HASH_SHA256, &expect);
+	TEST_EQ(memcmp(hash.raw, expect.raw, VB2_SHA256_DIGEST_SIZE), 0,
+		"  digest");
+
+	TEST_EQ(DigestFile(testfile, VB2_HASH_SHA256, digest,
+			   VB2_SHA256_DIGEST_SIZE - 1),
+		VB2_ERROR_SHA_FINALIZE_DIGEST_SIZE,
+		"DigestFile() digest too small");
+	TEST_NEQ(DigestFile(testfile, VB2_HASH_INVALID, digest,
+			    sizeof(digest)), VB2_SUCCESS,
+		 "DigestFile() invalid algorithm");
+
+	/* Reading a directory fails */
+	fd = open(temp_dir, O_RDONLY);
+	TEST_NEQ(vb2_hash_fd(fd, VB2_HASH_SHA256, &hash), VB2_SUCCESS,
+		 "vb2_hash_fd() read error");
+	close(fd);
+
+	unlink(testfile);
+	TEST_NEQ(DigestFile(testfile, VB2_HASH_SHA256, digest,
+			    sizeof(digest)), VB2_SUCCESS,
+		 "DigestFile() missing file");
+
+	free(testfile);
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc != 2) {
+		fprintf(stderr, "Usage: %s <temp_dir>\n", argv[0]);
+		return -1;
+	}
+
+	digest_file_tests(argv[1]);
+
+	return gTestSuccess ? 0 : 255;
+}
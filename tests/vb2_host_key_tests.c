@@ -6,8 +6,11 @@
  */
 
 #include "2common.h"
+#include "2rsa.h"
 #include "common/tests.h"
 #include "host_common.h"
+#include "host_key.h"
+#include "host_key_cache.h"
 
 /* Public key utility functions */
 static void public_key_tests(void)
@@ -60,9 +63,132 @@ static void public_key_tests(void)
 		"vb2_copy_packed_key data");
 }
 
+static struct vb2_packed_key *read_key(const char *keys_dir, int alg)
+{
+	char filename[1024];
+
+	snprintf(filename, sizeof(filename), "%s/key_%s.keyb", keys_dir,
+		 vb2_get_crypto_algorithm_file(alg));
+	return vb2_read_packed_keyb(filename, alg, 1);
+}
+
+static void key_cache_tests(const char *keys_dir)
+{
+	struct vb2_packed_key *k1 = read_key(keys_dir, VB2_ALG_RSA1024_SHA256);
+	struct vb2_packed_key *k2 = read_key(keys_dir, VB2_ALG_RSA2048_SHA256);
+	struct vb2_packed_key *k3 = read_key(keys_dir, VB2_ALG_RSA4096_SHA256);
+	struct vb2_packed_key *moved;
+	struct vb2_key_cache_stats stats;
+	struct vb2_key_cache *cache;
+	struct vb2_public_key key, ref;
+	uint32_t size;
+
+	TEST_PTR_NEQ(k1, NULL, "Read key 1");
+	TEST_PTR_NEQ(k2, NULL, "Read key 2");
+	TEST_PTR_NEQ(k3, NULL, "Read key 3");
+	if (!k1 || !k2 || !k3)
+		goto done;
+
+	TEST_PTR_EQ(vb2_key_cache_create(0), NULL, "Create with no entries");
+	cache = vb2_key_cache_create(2);
+	TEST_PTR_NEQ(cache, NULL, "Create");
+
+	/* A miss unpacks the same key, pointing into the cache's copy */
+	TEST_SUCC(vb2_unpack_key(&ref, k1), "Unpack key 1");
+	TEST_SUCC(vb2_key_cache_unpack(cache, &key, k1), "Miss");
+	TEST_EQ(key.sig_alg, ref.sig_alg, "  sig_alg");
+	TEST_EQ(key.hash_alg, ref.hash_alg, "  hash_alg");
+	TEST_EQ(key.arrsize, ref.arrsize, "  arrsize");
+	TEST_EQ(key.n0inv, ref.n0inv, "  n0inv");
+	TEST_EQ(memcmp(key.n, ref.n, key.arrsize * sizeof(uint32_t)), 0,
+		"  n");
+	TEST_EQ(memcmp(key.rr, ref.rr, key.arrsize * sizeof(uint32_t)), 0,
+		"  rr");
+	TEST_TRUE(key.n != ref.n, "  n copied");
+	vb2_key_cache_get_stats(cache, &stats);
+	TEST_EQ(stats.misses, 1, "  misses");
+	TEST_EQ(stats.hits, 0, "  hits");
+	TEST_EQ(stats.entries, 1, "  entries");
+
+	/* The same key at a different offset and version is a hit */
+	size = k1->key_offset + k1->key_size;
+	moved = calloc(1, size + 64);
+	memcpy(moved, k1, sizeof(*k1));
+	moved->key_offset += 64;
+	moved->key_version++;
+	memcpy((uint8_t *)moved + moved->key_offset, vb2_packed_key_data(k1),
+	       k1->key_size);
+	memset(&key, 0, sizeof(key));
+	TEST_SUCC(vb2_key_cache_unpack_buffer(cache, &key, (uint8_t *)moved,
+					      size + 64), "Hit");
+	TEST_EQ(memcmp(key.n, ref.n, key.arrsize * sizeof(uint32_t)), 0,
+		"  n");
+	free(moved);
+	vb2_key_cache_get_stats(cache, &stats);
+	TEST_EQ(stats.misses, 1, "  misses");
+	TEST_EQ(stats.hits, 1, "  hits");
+
+	/* Keys outlive the buffer they were unpacked from */
+	TEST_EQ(key.n0inv, ref.n0inv, "  n0inv after free");
+
+	/* Filling the cache evicts the least recently used key */
+	TEST_SUCC(vb2_key_cache_unpack(cache, &key, k2), "Key 2");
+	TEST_SUCC(vb2_key_cache_unpack(cache, &key, k1), "Key 1 again");
+	TEST_SUCC(vb2_key_cache_unpack(cache, &key, k3), "Key 3");
+	vb2_key_cache_get_stats(cache, &stats);
+	TEST_EQ(stats.misses, 3, "  misses");
+	TEST_EQ(stats.hits, 2, "  hits");
+	TEST_EQ(stats.evictions, 1, "  evictions");
+	TEST_EQ(stats.entries, 2, "  entries");
+	TEST_SUCC(vb2_key_cache_unpack(cache, &key, k1), "Key 1 kept");
+	TEST_SUCC(vb2_key_cache_unpack(cache, &key, k2), "Key 2 evicted");
+	vb2_key_cache_get_stats(cache, &stats);
+	TEST_EQ(stats.misses, 4, "  misses");
+	TEST_EQ(stats.hits, 3, "  hits");
+	TEST_EQ(stats.evictions, 2, "  evictions");
+
+	/* Errors are the same as without the cache, and aren't cached */
+	TEST_EQ(vb2_key_cache_unpack_buffer(cache, &key, (uint8_t *)k1,
+					    sizeof(*k1) - 1),
+		vb2_unpack_key_buffer(&ref, (uint8_t *)k1, sizeof(*k1) - 1),
+		"Buffer too small");
+	TEST_EQ(vb2_key_cache_unpack(cache, &key, NULL),
+		VB2_ERROR_UNPACK_KEY_BUFFER, "NULL key");
+	k3->algorithm = VB2_ALG_COUNT;
+	TEST_EQ(vb2_key_cache_unpack(cache, &key, k3),
+		vb2_unpack_key(&ref, k3), "Bad algorithm");
+	vb2_key_cache_get_stats(cache, &stats);
+	TEST_EQ(stats.misses, 4, "  misses");
+	TEST_EQ(stats.hits, 3, "  hits");
+
+	vb2_key_cache_free(cache);
+	vb2_key_cache_free(NULL);
+
+	/* With no cache, unpacks like vb2_unpack_key() */
+	TEST_SUCC(vb2_unpack_key(&ref, k2), "Unpack key 2");
+	TEST_SUCC(vb2_key_cache_unpack(NULL, &key, k2), "No cache");
+	TEST_PTR_EQ(key.n, ref.n, "  n in place");
+
+	/* The default cache is created once */
+	TEST_PTR_NEQ(vb2_key_cache_default(), NULL, "Default cache");
+	TEST_PTR_EQ(vb2_key_cache_default(), vb2_key_cache_default(),
+		    "  same cache");
+
+done:
+	free(k1);
+	free(k2);
+	free(k3);
+}
+
 int main(int argc, char* argv[])
 {
+	if (argc != 2) {
+		fprintf(stderr, "Usage: %s <keys_dir>\n", argv[0]);
+		return -1;
+	}
+
 	public_key_tests();
+	key_cache_tests(argv[1]);
 
 	return gTestSuccess ? 0 : 255;
 }
@@ -113,6 +113,9 @@ vb2_error_t VbExDiskRead(vb2ex_disk_handle_t h, uint64_t lba_start,
 
 int AllocAndReadGptData(vb2ex_disk_handle_t disk_handle, GptData *gptdata)
 {
+	static GptHeader mock_gpt_header;
+
+	gptdata->primary_header = (uint8_t *)&mock_gpt_header;
 	return GPT_SUCCESS;
 }
 
@@ -157,6 +160,7 @@ vb2_error_t vb2_unpack_key_buffer(struct vb2_public_key *key,
 	if (--unpack_key_fail == 0)
 		return VB2_ERROR_MOCK;
 
+	key->hash_alg = VB2_HASH_SHA256;
 	return VB2_SUCCESS;
 }
 
@@ -197,10 +201,9 @@ vb2_error_t vb2_verify_kernel_preamble(struct vb2_kernel_preamble *preamble,
 	return VB2_SUCCESS;
 }
 
-vb2_error_t vb2_verify_data(const uint8_t *data, uint32_t size,
-			    struct vb2_signature *sig,
-			    const struct vb2_public_key *key,
-			    const struct vb2_workbuf *wb)
+vb2_error_t vb2_verify_digest(const struct vb2_public_key *key,
+			      struct vb2_signature *sig, const uint8_t *digest,
+			      const struct vb2_workbuf *wb)
 {
 	if (verify_data_fail)
 		return VB2_ERROR_MOCK;
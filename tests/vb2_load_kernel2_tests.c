@@ -27,6 +27,13 @@ struct disk_stream {
 
 	/* Number of sectors left */
 	uint64_t sectors_left;
+
+	/* Outstanding asynchronous reads, oldest first */
+	struct {
+		uint32_t bytes;
+		void *buffer;
+	} pending[VB2_STREAM_ASYNC_DEPTH];
+	uint32_t pending_count;
 };
 
 /* Represent a "kernel" located on the disk */
@@ -59,6 +66,12 @@ static struct mock_kernel kernels[MAX_MOCK_KERNELS];
 static int kernel_count;
 static struct mock_kernel *cur_kernel;
 
+/* Stream reads; these are not reset by reset_common_data() */
+static int mock_async;
+static int mock_async_waits;
+static uint64_t mock_fail_sector;
+static int mock_open_streams;
+
 static void add_mock_kernel(uint64_t sector, vb2_error_t rv)
 {
 	if (kernel_count >= ARRAY_SIZE(kernels)) {
@@ -120,6 +133,9 @@ static void reset_common_data(void)
 	memset(&kernels, 0, sizeof(kernels));
 	kernel_count = 0;
 	cur_kernel = NULL;
+
+	mock_fail_sector = UINT64_MAX;
+	mock_open_streams = 0;
 }
 
 /* Mocks */
@@ -142,10 +158,15 @@ vb2_error_t VbExStreamOpen(vb2ex_disk_handle_t handle, uint64_t lba_start,
 	if (lba_start + lba_count > disk_info.lba_count)
 		return VB2_ERROR_UNKNOWN;
 
+	if (mock_open_streams)
+		TEST_TRUE(0, "  stream opened while another is open");
+	mock_open_streams++;
+
 	s = malloc(sizeof(*s));
 	s->handle = handle;
 	s->sector = lba_start;
 	s->sectors_left = lba_count;
+	s->pending_count = 0;
 
 	*stream = (void *)s;
 
@@ -175,6 +196,10 @@ vb2_error_t VbExStreamRead(VbExStream_t stream, uint32_t bytes, void *buffer)
 	if (sectors > s->sectors_left)
 		return VB2_ERROR_UNKNOWN;
 
+	if (mock_fail_sector >= s->sector &&
+	    mock_fail_sector < s->sector + sectors)
+		return VB2_ERROR_UNKNOWN;
+
 	memset(buffer, 0, bytes);
 	for (i = 0; i < kernel_count; i++) {
 		if (kernels[i].sector >= s->sector &&
@@ -196,14 +221,57 @@ vb2_error_t VbExStreamRead(VbExStream_t stream, uint32_t bytes, void *buffer)
 	return VB2_SUCCESS;
 }
 
+vb2_error_t VbExStreamReadAsync(VbExStream_t stream, uint32_t bytes,
+				void *buffer)
+{
+	struct disk_stream *s = (struct disk_stream *)stream;
+
+	if (!mock_async)
+		return VB2_ERROR_EX_UNIMPLEMENTED;
+
+	if (s->pending_count >= VB2_STREAM_ASYNC_DEPTH) {
+		TEST_TRUE(0, "  too many asynchronous reads");
+		return VB2_ERROR_UNKNOWN;
+	}
+
+	s->pending[s->pending_count].bytes = bytes;
+	s->pending[s->pending_count].buffer = buffer;
+	s->pending_count++;
+	return VB2_SUCCESS;
+}
+
+vb2_error_t VbExStreamWaitAsync(VbExStream_t stream)
+{
+	struct disk_stream *s = (struct disk_stream *)stream;
+	uint32_t bytes;
+	void *buffer;
+
+	if (!s->pending_count) {
+		TEST_TRUE(0, "  no asynchronous read to wait for");
+		return VB2_ERROR_UNKNOWN;
+	}
+
+	bytes = s->pending[0].bytes;
+	buffer = s->pending[0].buffer;
+	s->pending_count--;
+	memmove(&s->pending[0], &s->pending[1],
+		s->pending_count * sizeof(s->pending[0]));
+	mock_async_waits++;
+
+	return VbExStreamRead(stream, bytes, buffer);
+}
+
 void VbExStreamClose(VbExStream_t stream)
 {
+	if (stream)
+		mock_open_streams--;
 	free(stream);
 }
 
 vb2_error_t vb2_unpack_key_buffer(struct vb2_public_key *key,
 				  const uint8_t *buf, uint32_t size)
 {
+	key->hash_alg = VB2_HASH_SHA256;
 	return cur_kernel->rv;
 }
 
@@ -237,10 +305,9 @@ vb2_error_t vb2_verify_kernel_preamble(struct vb2_kernel_preamble *preamble,
 	return cur_kernel->rv;
 }
 
-vb2_error_t vb2_verify_data(const uint8_t *data, uint32_t size,
-			    struct vb2_signature *sig,
-			    const struct vb2_public_key *key,
-			    const struct vb2_workbuf *w)
+vb2_error_t vb2_verify_digest(const struct vb2_public_key *key,
+			      struct vb2_signature *sig, const uint8_t *digest,
+			      const struct vb2_workbuf *w)
 {
 	return cur_kernel->rv;
 }
@@ -468,11 +535,37 @@ static void load_minios_kernel_tests(void)
 	TEST_EQ(sd->kernel_version, 0x50006, "  SD kernel version");
 	TEST_PTR_EQ(lkp.disk_handle, disk_info.handle,
 		    "  fill disk_handle when success");
+
+	reset_common_data();
+	disk_info.bytes_per_lba = 512;
+	disk_info.lba_count = 8192;
+	add_mock_kernel(2100, VB2_SUCCESS);
+	mock_fail_sector = 10;
+	TEST_SUCC(vb2api_load_minios_kernel(ctx, &lkp, &disk_info, 0),
+		  "kernel after a batch which fails to read");
+	TEST_EQ(cur_kernel->sector, 2100, "  select kernel");
+
+	reset_common_data();
+	disk_info.bytes_per_lba = 512;
+	disk_info.lba_count = 8192;
+	add_mock_kernel(1000, VB2_ERROR_MOCK);
+	add_mock_kernel(3000, VB2_SUCCESS);
+	TEST_SUCC(vb2api_load_minios_kernel(ctx, &lkp, &disk_info, 0),
+		  "kernel in the batch after an invalid kernel");
+	TEST_EQ(cur_kernel->sector, 3000, "  select second kernel");
+	TEST_EQ(kernels[1].read_count, 2, "  scanned once, then loaded");
+	TEST_EQ(mock_open_streams, 0, "  streams closed");
 }
 
 int main(void)
 {
+	/* Synchronous reads */
+	load_minios_kernel_tests();
+
+	/* Double-buffered asynchronous reads */
+	mock_async = 1;
 	load_minios_kernel_tests();
+	TEST_NEQ(mock_async_waits, 0, "Asynchronous reads used");
 
 	return gTestSuccess ? 0 : 255;
 }
@@ -34,8 +34,15 @@ static struct mock_part mock_parts[MOCK_PART_COUNT];
 static int mock_part_next;
 
 /* Mock data */
-static uint8_t kernel_buffer[80000];
+static uint8_t kernel_buffer[1024 * 1024];
 static int disk_read_to_fail;
+static int disk_read_count;
+static int async_unimplemented;
+static int async_submit_to_fail;
+static int async_submit_count;
+static int async_wait_count;
+static vb2_error_t async_pending[VB2_STREAM_ASYNC_DEPTH];
+static int async_pending_count;
 static int gpt_init_fail;
 static int keyblock_verify_fail;  /* 0=ok, 1=sig, 2=hash */
 static int preamble_verify_fail;
@@ -62,6 +69,13 @@ static struct vb2_packed_key mock_key;
 static void ResetMocks(void)
 {
 	disk_read_to_fail = -1;
+	disk_read_count = 0;
+
+	async_unimplemented = 0;
+	async_submit_to_fail = 0;
+	async_submit_count = 0;
+	async_wait_count = 0;
+	async_pending_count = 0;
 
 	gpt_init_fail = 0;
 	keyblock_verify_fail = 0;
@@ -164,14 +178,57 @@ vb2_error_t vb2_gbb_read_recovery_key(struct vb2_context *c,
 vb2_error_t VbExDiskRead(vb2ex_disk_handle_t h, uint64_t lba_start,
 			 uint64_t lba_count, void *buffer)
 {
+	disk_read_count++;
 	if ((int)lba_start == disk_read_to_fail)
 		return VB2_ERROR_MOCK;
 
 	return VB2_SUCCESS;
 }
 
+/*
+ * Do the read at submission time, and hand back its result when the caller
+ * waits for it.
+ */
+vb2_error_t VbExStreamReadAsync(VbExStream_t stream, uint32_t bytes,
+				void *buffer)
+{
+	if (async_unimplemented)
+		return VB2_ERROR_EX_UNIMPLEMENTED;
+	if (++async_submit_count == async_submit_to_fail)
+		return VB2_ERROR_MOCK;
+	if (async_pending_count >= VB2_STREAM_ASYNC_DEPTH) {
+		TEST_TRUE(0, "  too many async reads in flight");
+		return VB2_ERROR_MOCK;
+	}
+
+	async_pending[async_pending_count++] =
+		VbExStreamRead(stream, bytes, buffer);
+	return VB2_SUCCESS;
+}
+
+vb2_error_t VbExStreamWaitAsync(VbExStream_t stream)
+{
+	vb2_error_t rv;
+	int i;
+
+	if (!async_pending_count) {
+		TEST_TRUE(0, "  waited with no async read in flight");
+		return VB2_ERROR_MOCK;
+	}
+
+	async_wait_count++;
+	rv = async_pending[0];
+	for (i = 1; i < async_pending_count; i++)
+		async_pending[i - 1] = async_pending[i];
+	async_pending_count--;
+	return rv;
+}
+
 int AllocAndReadGptData(vb2ex_disk_handle_t disk_handle, GptData *gptdata)
 {
+	static GptHeader mock_gpt_header;
+
+	gptdata->primary_header = (uint8_t *)&mock_gpt_header;
 	return GPT_SUCCESS;
 }
 
@@ -218,6 +275,7 @@ vb2_error_t vb2_unpack_key_buffer(struct vb2_public_key *key,
 	if (--unpack_key_fail == 0)
 		return VB2_ERROR_MOCK;
 
+	key->hash_alg = VB2_HASH_SHA256;
 	return VB2_SUCCESS;
 }
 
@@ -259,10 +317,9 @@ vb2_error_t vb2_verify_kernel_preamble(struct vb2_kernel_preamble *preamble,
 	return VB2_SUCCESS;
 }
 
-vb2_error_t vb2_verify_data(const uint8_t *data, uint32_t size,
-			    struct vb2_signature *sig,
-			    const struct vb2_public_key *key,
-			    const struct vb2_workbuf *wb)
+vb2_error_t vb2_verify_digest(const struct vb2_public_key *key,
+			      struct vb2_signature *sig, const uint8_t *digest,
+			      const struct vb2_workbuf *wb)
 {
 	if (verify_data_fail)
 		return VB2_ERROR_MOCK;
@@ -319,6 +376,12 @@ static void load_kernel_tests(void)
 	TEST_STR_EQ((char *)lkp.partition_guid.u.raw, fake_guid, "  guid");
 	TEST_EQ(gpt_flag_external, 0, "GPT was internal");
 	TEST_NEQ(sd->flags & VB2_SD_FLAG_KERNEL_SIGNED, 0, "  use signature");
+	TEST_EQ(sd->timing.phase[VB2_TIMING_GPT_LOAD].count, 1, "  timed GPT");
+	TEST_EQ(sd->timing.kernel_try_count, 1, "  timed one kernel");
+	TEST_EQ(sd->timing.kernel_try[0].partition, 1, "  kernel partition");
+	TEST_EQ(sd->timing.kernel_try[0].result, VB2_SUCCESS,
+		"  kernel result");
+	TEST_EQ(sd->timing.phase[VB2_TIMING_RSA].count, 1, "  timed RSA");
 
 	ResetMocks();
 	memcpy(&mock_parts[1].kbh, &mock_parts[0].kbh,
@@ -347,6 +410,12 @@ static void load_kernel_tests(void)
 	keyblock_verify_fail = 1;
 	test_load_kernel(VB2_ERROR_LK_INVALID_KERNEL_FOUND,
 			 "Fail key block sig");
+	TEST_EQ(sd->timing.kernel_try_count, 1, "  timed one kernel");
+	TEST_EQ(sd->timing.kernel_try[0].result,
+		VB2_ERROR_LOAD_PARTITION_VERIFY_VBLOCK, "  kernel result");
+	TEST_EQ(sd->timing.kernel_try[0].bytes, 65536, "  read vblock");
+	TEST_EQ(sd->timing.phase[VB2_TIMING_KEYBLOCK_VERIFY].count, 1,
+		"  timed keyblock");
 
 	/* In dev mode, fail if hash is bad too */
 	ResetMocks();
@@ -650,6 +719,49 @@ static void load_kernel_tests(void)
 	kph.body_signature.data_size = 8192;
 	test_load_kernel(VB2_SUCCESS, "Kernel tiny");
 
+	ResetMocks();
+	mock_parts[0].e.ending_lba = 100 + 2048 - 1;
+	kph.body_signature.data_size = 600 * 1024;
+	test_load_kernel(VB2_SUCCESS, "Kernel body read in chunks");
+	/* vblock read, then 536 KB of body in 256 KB chunks */
+	TEST_EQ(disk_read_count, 4, "  disk reads");
+	TEST_EQ(async_submit_count, 3, "  async reads");
+	TEST_EQ(async_wait_count, 3, "  async waits");
+
+	ResetMocks();
+	mock_parts[0].e.ending_lba = 100 + 2048 - 1;
+	kph.body_signature.data_size = 600 * 1024;
+	async_unimplemented = 1;
+	test_load_kernel(VB2_SUCCESS, "Kernel body read without async reads");
+	TEST_EQ(disk_read_count, 4, "  disk reads");
+	TEST_EQ(async_wait_count, 0, "  async waits");
+
+	ResetMocks();
+	async_unimplemented = 1;
+	disk_read_to_fail = 228;
+	test_load_kernel(VB2_ERROR_LK_INVALID_KERNEL_FOUND,
+			 "Fail reading kernel data without async reads");
+
+	/* Second chunk fails while the third is in flight */
+	ResetMocks();
+	mock_parts[0].e.ending_lba = 100 + 2048 - 1;
+	kph.body_signature.data_size = 600 * 1024;
+	disk_read_to_fail = 228 + 512;
+	test_load_kernel(VB2_ERROR_LK_INVALID_KERNEL_FOUND,
+			 "Fail async kernel data read");
+	TEST_EQ(async_submit_count, 3, "  async reads");
+	TEST_EQ(async_pending_count, 0, "  outstanding reads waited for");
+
+	/* Queueing the second chunk fails while the first is in flight */
+	ResetMocks();
+	mock_parts[0].e.ending_lba = 100 + 2048 - 1;
+	kph.body_signature.data_size = 600 * 1024;
+	async_submit_to_fail = 2;
+	test_load_kernel(VB2_ERROR_LK_INVALID_KERNEL_FOUND,
+			 "Fail queueing async kernel data read");
+	TEST_EQ(async_wait_count, 1, "  async waits");
+	TEST_EQ(async_pending_count, 0, "  outstanding reads waited for");
+
 	ResetMocks();
 	disk_read_to_fail = 228;
 	test_load_kernel(VB2_ERROR_LK_INVALID_KERNEL_FOUND,
@@ -13,6 +13,7 @@
 #include "2sysincludes.h"
 #include "common/boot_mode.h"
 #include "common/tests.h"
+#include "vboot_struct.h"
 
 /* Common context for tests */
 static uint8_t workbuf[VB2_FIRMWARE_WORKBUF_RECOMMENDED_SIZE]
@@ -30,6 +31,7 @@ static void *mock_resource_ptr;
 static uint32_t mock_resource_size;
 static int mock_tpm_clear_called;
 static int mock_tpm_clear_retval;
+static uint32_t mock_time_ms;
 
 static void reset_common_data(void)
 {
@@ -53,6 +55,7 @@ static void reset_common_data(void)
 
 	mock_tpm_clear_called = 0;
 	mock_tpm_clear_retval = VB2_SUCCESS;
+	mock_time_ms = 0;
 
 	SET_BOOT_MODE(ctx, VB2_BOOT_MODE_NORMAL);
 };
@@ -85,6 +88,11 @@ vb2_error_t vb2ex_tpm_clear_owner(struct vb2_context *c)
 	return mock_tpm_clear_retval;
 }
 
+uint32_t vb2ex_mtime(void)
+{
+	return mock_time_ms;
+}
+
 /* Tests */
 static void init_workbuf_tests(void)
 {
@@ -334,13 +342,23 @@ static void gbb_tests(void)
 	gbbsrc.header_size--;
 	TEST_EQ(vb2_read_gbb_header(ctx, &gbbdest),
 		VB2_ERROR_GBB_HEADER_SIZE, "read gbb header size");
+	memset(&sd->timing, 0, sizeof(sd->timing));
 	TEST_EQ(vb2_fw_init_gbb(ctx),
 		VB2_ERROR_GBB_HEADER_SIZE, "init gbb failure");
+	TEST_EQ(sd->timing.phase[VB2_TIMING_GBB_READ].count, 1,
+		"  timed failed GBB read");
+	TEST_EQ(sd->timing.phase[VB2_TIMING_GBB_READ].bytes, 0,
+		"  no GBB bytes read");
 	gbbsrc.header_size++;
 
 	/* Init GBB */
 	int used_before = sd->workbuf_used;
+	memset(&sd->timing, 0, sizeof(sd->timing));
 	TEST_SUCC(vb2_fw_init_gbb(ctx), "init gbb");
+	TEST_EQ(sd->timing.phase[VB2_TIMING_GBB_READ].count, 1,
+		"  timed GBB read");
+	TEST_EQ(sd->timing.phase[VB2_TIMING_GBB_READ].bytes, sizeof(gbbsrc),
+		"  GBB read bytes");
 	/* Manually calculate the location of GBB since we have mocked out the
 	   original definition of vb2_get_gbb. */
 	struct vb2_gbb_header *current_gbb = vb2_member_of(sd, sd->gbb_offset);
@@ -1125,6 +1143,62 @@ static void use_dev_screen_short_delay_tests(void)
 		"short delay: yes");
 }
 
+static void timing_tests(void)
+{
+	struct vb2_timing_phase_record *rec;
+	struct vb2_timing_kernel_try *try;
+	uint8_t vbsd_buf[VB2_VBSD_SIZE];
+	VbSharedDataHeader *vbsd = (VbSharedDataHeader *)vbsd_buf;
+	int i;
+
+	/* Phases accumulate */
+	reset_common_data();
+	rec = &sd->timing.phase[VB2_TIMING_RSA];
+	TEST_EQ(rec->count, 0, "Timing starts empty");
+	vb2_timing_add(ctx, VB2_TIMING_RSA, 10, 5, 256);
+	vb2_timing_add(ctx, VB2_TIMING_RSA, 20, 7, 512);
+	TEST_EQ(rec->start_ms, 10, "  first start");
+	TEST_EQ(rec->elapsed_ms, 12, "  total time");
+	TEST_EQ(rec->count, 2, "  count");
+	TEST_EQ(rec->bytes, 768, "  total bytes");
+
+	mock_time_ms = 50;
+	vb2_timing_end(ctx, VB2_TIMING_BODY_HASH, 40, 1000);
+	rec = &sd->timing.phase[VB2_TIMING_BODY_HASH];
+	TEST_EQ(rec->start_ms, 40, "Timing end start");
+	TEST_EQ(rec->elapsed_ms, 10, "  time until now");
+	TEST_EQ(rec->bytes, 1000, "  bytes");
+
+	/* Kernel tries past the end of the array are only counted */
+	reset_common_data();
+	mock_time_ms = 100;
+	for (i = 0; i < VB2_TIMING_MAX_KERNEL_TRIES + 2; i++)
+		vb2_timing_kernel_try(ctx, i + 1, 90 - i, 4096 * i,
+				      i ? VB2_ERROR_MOCK : VB2_SUCCESS);
+	TEST_EQ(sd->timing.kernel_try_count, VB2_TIMING_MAX_KERNEL_TRIES + 2,
+		"Kernel tries counted");
+	try = &sd->timing.kernel_try[0];
+	TEST_EQ(try->partition, 1, "  first partition");
+	TEST_EQ(try->elapsed_ms, 10, "  first time");
+	TEST_EQ(try->result, VB2_SUCCESS, "  first result");
+	try = &sd->timing.kernel_try[VB2_TIMING_MAX_KERNEL_TRIES - 1];
+	TEST_EQ(try->partition, VB2_TIMING_MAX_KERNEL_TRIES,
+		"  last recorded partition");
+	TEST_EQ(try->start_ms, 90 - (VB2_TIMING_MAX_KERNEL_TRIES - 1),
+		"  last recorded start");
+	TEST_EQ(try->bytes, 4096 * (VB2_TIMING_MAX_KERNEL_TRIES - 1),
+		"  last recorded bytes");
+	TEST_EQ(try->result, VB2_ERROR_MOCK, "  last recorded result");
+
+	/* Exported to the OS */
+	vb2_timing_add(ctx, VB2_TIMING_GPT_LOAD, 1, 2, 3);
+	memset(vbsd_buf, 0xaa, sizeof(vbsd_buf));
+	vb2api_export_vbsd(ctx, vbsd);
+	TEST_EQ(vbsd->struct_version, 4, "Export VBSD version");
+	TEST_SUCC(memcmp(vbsd->boot_timing, &sd->timing, sizeof(sd->timing)),
+		  "  timing exported");
+}
+
 int main(int argc, char* argv[])
 {
 	init_workbuf_tests();
@@ -1144,6 +1218,7 @@ int main(int argc, char* argv[])
 	dev_default_boot_tests();
 	fill_dev_boot_flags_tests();
 	use_dev_screen_short_delay_tests();
+	timing_tests();
 
 	return gTestSuccess ? 0 : 255;
 }
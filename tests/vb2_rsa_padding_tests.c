@@ -8,6 +8,7 @@
 
 #include "2common.h"
 #include "2rsa.h"
+#include "2rsa_private.h"
 #include "2sysincludes.h"
 #include "common/tests.h"
 #include "file_keys.h"
@@ -138,6 +139,48 @@ static void test_verify_digest(struct vb2_public_key *key) {
 		VB2_ERROR_RSA_PADDING, "vb2_rsa_verify_digest() bad sig end");
 }
 
+#if defined(ENABLE_HWCRYPTO_RSA_TESTS) && defined(VB2_X86_RSA_AVX2)
+/**
+ * Test the AVX2 modexp engine computes the same results as the SSE2 one.
+ */
+static void test_x86_engines(struct vb2_public_key *key)
+{
+	uint8_t workbuf[VB2_VERIFY_DIGEST_WORKBUF_BYTES]
+		 __attribute__((aligned(VB2_WORKBUF_ALIGN)));
+	uint8_t sig_sse2[RSA1024NUMBYTES], sig_avx2[RSA1024NUMBYTES];
+	const int exps[] = { 3, 65537 };
+	int mismatch = 0;
+	int i, e;
+
+	if (!vb2_modexp_avx2_supported()) {
+		fprintf(stderr, "Skipping AVX2 modexp tests; no AVX2\n");
+		return;
+	}
+
+	for (e = 0; e < ARRAY_SIZE(exps); e++) {
+		for (i = 0; i < ARRAY_SIZE(signatures); i++) {
+			memcpy(sig_sse2, signatures[i], sizeof(sig_sse2));
+			memcpy(sig_avx2, signatures[i], sizeof(sig_avx2));
+			if (vb2_modexp_sse2(key, sig_sse2, workbuf,
+					    sizeof(workbuf), exps[e]) ||
+			    vb2_modexp_avx2(key, sig_avx2, workbuf,
+					    sizeof(workbuf), exps[e]) ||
+			    memcmp(sig_sse2, sig_avx2, sizeof(sig_sse2))) {
+				fprintf(stderr, "Vector %d e=%d mismatch\n",
+					i, exps[e]);
+				mismatch++;
+			}
+		}
+	}
+	TEST_EQ(mismatch, 0, "AVX2 modexp matches SSE2");
+
+	memcpy(sig_avx2, signatures[0], sizeof(sig_avx2));
+	TEST_EQ(vb2_modexp_avx2(key, sig_avx2, workbuf, sizeof(sig_avx2) * 3,
+				65537),
+		VB2_ERROR_WORKBUF_SMALL, "AVX2 modexp small workbuf");
+}
+#endif
+
 int main(int argc, char *argv[])
 {
 	struct vb2_public_key k2;
@@ -162,6 +205,9 @@ int main(int argc, char *argv[])
 	/* Run tests */
 	test_signatures(&k2);
 	test_verify_digest(&k2);
+#if defined(ENABLE_HWCRYPTO_RSA_TESTS) && defined(VB2_X86_RSA_AVX2)
+	test_x86_engines(&k2);
+#endif
 
 	/* Clean up and exit */
 	free(pk);
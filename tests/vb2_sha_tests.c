@@ -7,6 +7,7 @@
 
 #include <stdio.h>
 
+#include "2common.h"
 #include "2return_codes.h"
 #include "2rsa.h"
 #include "2sha.h"
@@ -131,6 +132,103 @@ static void sha512_tests(void)
 		"vb2_hash_block_size(VB2_HASH_SHA512)");
 }
 
+/*
+ * Hashing a buffer in one call may take a multi-block transform path (e.g.
+ * AVX2), while feeding it one byte at a time always transforms single blocks.
+ * Cover every count of leftover blocks in a multi-block batch.
+ */
+static void multiblock_tests(void)
+{
+	struct vb2_digest_context dc;
+	struct vb2_hash hash;
+	uint8_t digest[VB2_SHA512_DIGEST_SIZE];
+	uint8_t buf[20 * VB2_SHA512_BLOCK_SIZE + 17];
+	const enum vb2_hash_algorithm algs[] = {
+		VB2_HASH_SHA224, VB2_HASH_SHA256,
+		VB2_HASH_SHA384, VB2_HASH_SHA512,
+	};
+	uint32_t size, i, a;
+
+	for (i = 0; i < sizeof(buf); i++)
+		buf[i] = (uint8_t)(i * 7 + (i >> 8));
+
+	for (a = 0; a < ARRAY_SIZE(algs); a++) {
+		uint32_t block_size = vb2_hash_block_size(algs[a]);
+		int mismatch = 0;
+
+		for (size = block_size; size <= sizeof(buf);
+		     size += block_size + 1) {
+			vb2_hash_calculate(false, buf, size, algs[a], &hash);
+
+			vb2_digest_init(&dc, false, algs[a], 0);
+			for (i = 0; i < size; i++)
+				vb2_digest_extend(&dc, buf + i, 1);
+			vb2_digest_finalize(&dc, digest, sizeof(digest));
+
+			if (memcmp(hash.raw, digest,
+				   vb2_digest_size(algs[a])))
+				mismatch++;
+		}
+		TEST_EQ(mismatch, 0, vb2_get_hash_algorithm_name(algs[a]));
+	}
+}
+
+static void multi_buffer_tests(void)
+{
+	/* Mix of sizes around block and padding boundaries */
+	const uint32_t sizes[] = {
+		0, 1, 55, 56, 64, 119, 128, 1000, 4096, 9999, 64 * 17,
+		300, 64 * 3 + 7,
+	};
+	const enum vb2_hash_algorithm algs[] = {
+		VB2_HASH_SHA1, VB2_HASH_SHA224, VB2_HASH_SHA256,
+		VB2_HASH_SHA384, VB2_HASH_SHA512,
+	};
+	const void *bufs[ARRAY_SIZE(sizes)];
+	struct vb2_hash hashes[ARRAY_SIZE(sizes)];
+	struct vb2_hash expect;
+	uint8_t *data;
+	uint32_t a, i, count;
+
+	data = malloc(ARRAY_SIZE(sizes) * 10000);
+	for (i = 0; i < ARRAY_SIZE(sizes) * 10000; i++)
+		data[i] = (uint8_t)(i * 13 + (i >> 9));
+	for (i = 0; i < ARRAY_SIZE(sizes); i++)
+		bufs[i] = data + i * 10000;
+
+	for (a = 0; a < ARRAY_SIZE(algs); a++) {
+		/* Every batch size from a single buffer to all of them */
+		for (count = 1; count <= ARRAY_SIZE(sizes); count++) {
+			int mismatch = 0;
+
+			memset(hashes, 0, sizeof(hashes));
+			TEST_SUCC(vb2_hash_calculate_multi(false, bufs, sizes,
+							   count, algs[a],
+							   hashes),
+				  "vb2_hash_calculate_multi()");
+			for (i = 0; i < count; i++) {
+				vb2_hash_calculate(false, bufs[i], sizes[i],
+						   algs[a], &expect);
+				if (hashes[i].algo != algs[a] ||
+				    memcmp(hashes[i].raw, expect.raw,
+					   vb2_digest_size(algs[a])))
+					mismatch++;
+			}
+			TEST_EQ(mismatch, 0, "  digests match");
+		}
+	}
+
+	TEST_SUCC(vb2_hash_calculate_multi(false, bufs, sizes, 0,
+					   VB2_HASH_SHA256, hashes),
+		  "vb2_hash_calculate_multi() no buffers");
+	TEST_EQ(vb2_hash_calculate_multi(false, bufs, sizes, 2,
+					 VB2_HASH_INVALID, hashes),
+		VB2_ERROR_SHA_INIT_ALGORITHM,
+		"vb2_hash_calculate_multi() invalid alg");
+
+	free(data);
+}
+
 static void misc_tests(void)
 {
 	uint8_t digest[VB2_SHA512_DIGEST_SIZE];
@@ -251,6 +349,8 @@ int main(int argc, char *argv[])
 	sha1_tests();
 	sha256_tests();
 	sha512_tests();
+	multiblock_tests();
+	multi_buffer_tests();
 	misc_tests();
 	known_value_tests();
 